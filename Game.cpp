@@ -1,34 +1,71 @@
 #include "Game.h"
 #include "src/Rules.h"
 #include "src/IO.h"
-#include "src/MapSpec.h"
-#include "src/RandomAI.h"
+#include "src/Controller.h"
+#include "src/GameRecord.h"
+#include "src/Instrument.h"
+#include "src/Telemetry.h"
+#include "src/View.h"
 
 #include <algorithm>
 #include <iostream>
 #include <numeric>
+#include <random>
 #include <string>
+#include <unordered_map>
 
 // ---------- Constructors ----------
 Game::Game() : Game(std::random_device{}()) {}
 Game::Game(uint32_t seed) : seed_(seed), rng_(seed) {
     board_ = makeBoard(seed_);
 }
+Game::Game(uint32_t seed, int territories)
+    : seed_(seed), territories_(territories), rng_(seed) {
+    board_ = makeBoard(seed_);
+}
+Game::Game(std::shared_ptr<const MapTopology> map, uint32_t seed)
+    : seed_(seed), territories_(map->count()), map_(std::move(map)), rng_(seed) {
+    board_ = makeBoard(seed_);
+}
 
 // ---------- Accessors ----------
 Board& Game::board() { return board_; }
 const Board& Game::board() const { return board_; }
+int Game::turnsPlayed() const { return turns_; }
+PlayerId Game::toMove() const { return current_; }
+GameState Game::status() const { return status_; }
+const Rules::BattleLosses& Game::lastBattle() const { return lastBattle_; }
 
 // ---------- Setup ----------
 void Game::resetBoard(uint32_t seed) {
     seed_ = seed;
-    rng_.seed(seed_);
+    rng_ = Rng::Stream(seed_);
     board_ = makeBoard(seed_);
 }
 
+void Game::setBattleSeed(uint32_t seed) {
+    rng_ = Rng::Stream(seed);
+}
+
+void Game::setRepetitionLimit(int n) {
+    repetitionLimit_ = std::max(0, n);
+}
+
+void Game::setRecorder(GameRecorder* r) {
+    recorder_ = r;
+}
+
+void Game::setTelemetry(Telemetry::GameLog* t) {
+    telemetry_ = t;
+}
+
+void Game::setBlitz(bool on) {
+    blitz_ = on;
+}
+
 void Game::setupStartingPositions(uint32_t seed) {
     if (!seed) seed = seed_;  // default to current seed
-    std::mt19937 localRng(seed);
+    Rng::Stream localRng(seed);
     int n = board_.count();
 
     std::vector<int> ids(n);
@@ -36,16 +73,17 @@ void Game::setupStartingPositions(uint32_t seed) {
     std::shuffle(ids.begin(), ids.end(), localRng);
 
     for (int k = 0; k < n; ++k) {
-        auto& T = board_.at(ids[k]);
-        T.owner  = (k < n / 2) ? PlayerId::P1 : PlayerId::P2;
-        T.armies = 1;
+        board_.place(ids[k], (k < n / 2) ? PlayerId::P1 : PlayerId::P2, 1);
     }
 }
 
 // ---------- Board creation ----------
 Board Game::makeBoard(uint32_t seed) {
-    auto terrs = MapSpec::build20(seed);
-    Board b(std::move(terrs));
+    if (map_) return Board(map_);             // shared map, validated by its owner
+    auto terrs = territories_ == MapSpec::kDefaultTerritories
+        ? MapSpec::build20(seed)
+        : MapSpec::build(territories_, seed);
+    Board b(terrs);
 
     if (!b.validateAdjUndirected())
         std::cerr << "[Error] Map adjacency is not symmetric.\n";
@@ -70,9 +108,17 @@ void Game::printRules() const {
 
 // ---------- Helpers ----------
 bool Game::anyLegalAttack(PlayerId p) const {
-    auto borders = Rules::borders(board_, p);
-    for (TerrId from : borders) {
-        if (board_.at(from).armies < 2) continue;
+    if (board_.hasMasks()) {
+        const TerrMask& enemy = board_.ownerMask(p == PlayerId::P1 ? PlayerId::P2 : PlayerId::P1);
+        bool any = false;
+        board_.frontierMask(p).forEach([&](TerrId from) {
+            if (!any && board_.armies(from) >= 2 && (board_.adjMask(from) & enemy).any())
+                any = true;
+        });
+        return any;
+    }
+    for (TerrId from : board_.frontier(p)) {
+        if (board_.armies(from) < 2) continue;
         for (TerrId to : board_.neighbors(from))
             if (Rules::canAttack(board_, from, to, p)) return true;
     }
@@ -80,9 +126,18 @@ bool Game::anyLegalAttack(PlayerId p) const {
 }
 
 bool Game::anyLegalFortify(PlayerId p) const {
+    if (board_.hasMasks()) {
+        const TerrMask& own = board_.ownerMask(p);
+        bool any = false;
+        own.forEach([&](TerrId from) {
+            if (!any && board_.armies(from) >= 2 && (board_.adjMask(from) & own).any())
+                any = true;
+        });
+        return any;
+    }
     auto owned = Rules::owned(board_, p);
     for (TerrId from : owned) {
-        if (board_.at(from).armies < 2) continue;
+        if (board_.armies(from) < 2) continue;
         for (TerrId to : board_.neighbors(from))
             if (Rules::canFortify(board_, from, to, p)) return true;
     }
@@ -91,127 +146,318 @@ bool Game::anyLegalFortify(PlayerId p) const {
 
 // ---------- Main game loop ----------
 GameState Game::play(bool cpuAsP2) {
-    using std::to_string;
-    PlayerId current = PlayerId::P1;
-    auto nextPlayer = [](PlayerId p){ return p == PlayerId::P1 ? PlayerId::P2 : PlayerId::P1; };
-
-    constexpr int MAX_TURNS = 500;
-    constexpr int MAX_STALE = 60;
-    constexpr int CPU_MAX_ATTACKS = 6;
-
-    int turns = 0;
-    int stale = 0;
-    GameState status = Rules::gameStatus(board_);
-
-    while (status == GameState::Ongoing) {
-        if (++turns > MAX_TURNS) { status = GameState::Draw; break; }
-
-        bool captured = false;
-        IO::println(current == PlayerId::P1 ? "\n-- Player 1 turn --" : "\n-- Player 2 turn --");
-        IO::printBoardColor(board_, 3);
-
-        // ---------- Reinforcement phase ----------
-        int base = Rules::baseReinforcements(board_, current);
-        TerrId bonusT = -1;
-        if (Rules::chainOf5BonusTarget(board_, current, bonusT)) {
-            board_.at(bonusT).armies += 5;
-            IO::println((current == PlayerId::P1 ? "P1" : "P2") +
-                        std::string(" chain bonus: +5 to ") + board_.at(bonusT).name);
+    HumanController human;
+    RandomAIController cpu(seed_ ^ 0x9E3779B9u);
+    HumanController human2;
+    ConsoleView view;
+    if (cpuAsP2) return play(human, cpu, view);
+    return play(human, human2, view);
+}
+
+GameState Game::play(Controller& p1, Controller& p2, View& view) {
+    start(view);
+    while (pending_.kind != DecisionKind::None)
+        answer(pending_.player == PlayerId::P1 ? p1 : p2, view);
+    return finish(view);
+}
+
+// ---------- Step engine ----------
+void Game::start(View& view) {
+    current_ = PlayerId::P1;
+    turns_ = 0;
+    stale_ = 0;
+    status_ = Rules::gameStatus(board_);
+    seen_.clear();
+    capturedSince_[0] = capturedSince_[1] = true;
+    pending_ = Decision{};
+    if (recorder_) recorder_->begin(seed_, board_);
+    if (telemetry_) telemetry_->begin();
+    nextTurn(view);
+}
+
+const Game::Decision& Game::pendingDecision() const { return pending_; }
+
+bool Game::step(const Action& a, View& view) {
+    const Decision d = pending_;
+    switch (d.kind) {
+        case DecisionKind::None:
+            return false;
+
+        case DecisionKind::Reinforce: {
+            if (!a.pass) {
+                MR_TIME_PHASE(kReinforcePhase);
+                if (!reinforce(a.to)) return false;
+            }
+            base_ = 0;
+            view.showBoard(board_);
+            status_ = Rules::gameStatus(board_);
+            if (status_ != GameState::Ongoing) pending_ = Decision{};
+            else enterAttack(view, true);
+            return true;
         }
 
-        if (current == PlayerId::P1 || !cpuAsP2) {
-            IO::println("Reinforcements: " + to_string(base));
-            TerrId where = IO::readOwnedTerritory(board_, current, "Place ALL reinforcements at (code): ");
-            board_.at(where).armies += base;
-        } else {
-            TerrId where = RandomAI::chooseReinforcement(board_, current, base, seed_++);
-            if (where >= 0) board_.at(where).armies += base;
+        case DecisionKind::Attack: {
+            if (a.pass) {
+                enterFortify(view);
+                return true;
+            }
+            if (!Rules::canAttack(board_, a.from, a.to, current_)) return false;
+            ++attacks_;
+            bool took;
+            {
+                MR_TIME_PHASE(kAttackPhase);
+                took = attack(a.from, a.to, blitz_ || a.blitz, view);
+            }
+            if (took) {
+                pending_.kind = DecisionKind::Move;
+                pending_.amount = std::max(1, board_.armies(a.from) - 1);
+                pending_.from = a.from;
+                pending_.to = a.to;
+            } else {
+                enterAttack(view, false);
+            }
+            return true;
         }
 
-        IO::printBoardColor(board_, 3);
-        status = Rules::gameStatus(board_);
-        if (status != GameState::Ongoing) break;
+        case DecisionKind::Move: {
+            if (a.amount < 1 || a.amount > d.amount) return false;
+            moveIn(d.from, d.to, a.amount, view);
+            pending_.from = pending_.to = -1;
+            if (status_ != GameState::Ongoing) pending_ = Decision{};
+            else enterAttack(view, false);
+            return true;
+        }
 
-        // ---------- Attack phase ----------
-        if (current == PlayerId::P1 || !cpuAsP2) {
-            if (!anyLegalAttack(current)) {
-                IO::println("No legal attacks. Skipping.");
-            } else {
-                while (true) {
-                    if (!anyLegalAttack(current)) { IO::println("No more attacks."); break; }
-                    if (IO::readYesNo("Attack?") != 'y') break;
-
-                    auto choice = IO::readAttackChoice(board_, current);
-                    Rules::BattleLosses loss{};
-                    bool took = Rules::applyBattle(board_, choice.from, choice.to, current, seed_++, &loss);
-
-                    IO::println("Battle: attacker -" + to_string(loss.attacker) +
-                                ", defender -" + to_string(loss.defender));
-                    IO::printBoardColor(board_, 3);
-
-                    if (took) {
-                        captured = true;
-                        IO::println("Captured " + board_.at(choice.to).name + "!");
-                        int maxMove = std::max(1, board_.at(choice.from).armies - 1);
-                        int amt = IO::readIntInRange("Move how many armies?", 1, maxMove);
-                        Rules::moveAfterCapture(board_, choice.from, choice.to, amt);
-                        IO::printBoardColor(board_, 3);
-                    }
-
-                    status = Rules::gameStatus(board_);
-                    if (status != GameState::Ongoing) break;
-                }
+        case DecisionKind::Fortify: {
+            if (!a.pass) {
+                if (!Rules::canFortifyPath(board_, a.from, a.to, current_) ||
+                    a.amount < 1 || a.amount >= board_.armies(a.from))
+                    return false;
+                MR_TIME_PHASE(kFortifyPhase);
+                fortify(a.from, a.to, a.amount);
+            }
+            closeTurn(view);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Game::answer(Controller& ctl, View& view) {
+    const Decision d = pending_;
+    switch (d.kind) {
+        case DecisionKind::None:
+            return;
+
+        case DecisionKind::Reinforce: {
+            TerrId t;
+            {
+                MR_TIME_PHASE(kReinforcePhase);
+                t = ctl.chooseReinforcement(board_, d.player, d.amount);
+            }
+            if (!step(Action::place(t), view)) step(Action::stop(), view);
+            return;
+        }
+
+        case DecisionKind::Attack: {
+            IO::AttackChoice c;
+            bool go;
+            {
+                MR_TIME_PHASE(kAttackPhase);
+                go = ctl.chooseAttack(board_, d.player, d.attacks, c);
+            }
+            if (!go || !step(Action::attack(c.from, c.to), view)) step(Action::stop(), view);
+            return;
+        }
+
+        case DecisionKind::Move: {
+            int n;
+            {
+                MR_TIME_PHASE(kAttackPhase);
+                n = ctl.chooseMoveAfterCapture(board_, d.from, d.to, d.amount);
             }
-        } else {
-            int attacks = 0;
-            while (attacks < CPU_MAX_ATTACKS) {
-                auto plan = RandomAI::chooseAttack(board_, current, seed_++);
-                if (!plan.valid) break;
-
-                Rules::BattleLosses loss{};
-                bool took = Rules::applyBattle(board_, plan.from, plan.to, current, seed_++, &loss);
-                if (took) {
-                    captured = true;
-                    int maxMove = std::max(1, board_.at(plan.from).armies - 1);
-                    if (maxMove > 0) {
-                        std::uniform_int_distribution<int> mv(1, maxMove);
-                        Rules::moveAfterCapture(board_, plan.from, plan.to, mv(rng_));
-                    }
-                }
-                ++attacks;
-                status = Rules::gameStatus(board_);
-                if (status != GameState::Ongoing) break;
+            step(Action::move(std::clamp(n, 1, d.amount)), view);
+            return;
+        }
+
+        case DecisionKind::Fortify: {
+            IO::FortifyChoice f;
+            bool go;
+            {
+                MR_TIME_PHASE(kFortifyPhase);
+                go = ctl.chooseFortify(board_, d.player, f);
             }
-            IO::printBoardColor(board_, 3);
+            // Like Rules::moveAfterCapture, an oversized move leaves one army behind.
+            if (go && f.from >= 0 && f.from < board_.count())
+                f.amount = std::min(f.amount, board_.armies(f.from) - 1);
+            if (!go || !step(Action::fortify(f.from, f.to, f.amount), view))
+                step(Action::stop(), view);
+            return;
         }
+    }
+}
+
+GameState Game::playTurn(Controller& ctl, View& view) {
+    const PlayerId p = pending_.player;
+    while (pending_.kind != DecisionKind::None && pending_.player == p) answer(ctl, view);
+    return status_;
+}
+
+void Game::adjudicate(GameState result, View& view) {
+    if (status_ != GameState::Ongoing || result == GameState::Ongoing) return;
+    status_ = result;
+    pending_ = Decision{};
+    view.message(result == GameState::Player1Wins ? "Adjudicated: Player 1 wins."
+                 : result == GameState::Player2Wins ? "Adjudicated: Player 2 wins."
+                                                    : "Adjudicated: draw.");
+}
+
+// ---------- Turn flow ----------
+void Game::nextTurn(View& view) {
+    pending_ = Decision{};
+    if (beginTurn(view) != GameState::Ongoing) return;
+    attacks_ = 0;
+    pending_.kind = DecisionKind::Reinforce;
+    pending_.player = current_;
+    pending_.amount = base_;
+}
 
-        if (status != GameState::Ongoing) break;
+void Game::enterAttack(View& view, bool first) {
+    if (!anyLegalAttack(current_)) {
+        view.message(first ? "No legal attacks. Skipping." : "No more attacks.");
+        return enterFortify(view);
+    }
+    if (first) MR_ENTER_PHASE(kAttackPhase);
+    pending_.kind = DecisionKind::Attack;
+    pending_.attacks = attacks_;
+}
+
+void Game::enterFortify(View& view) {
+    if (!anyLegalFortify(current_)) {
+        view.message("No legal fortify moves.");
+        return closeTurn(view);
+    }
+    MR_ENTER_PHASE(kFortifyPhase);
+    pending_.kind = DecisionKind::Fortify;
+}
 
-        // ---------- Fortify phase ----------
-        if (current == PlayerId::P1 || !cpuAsP2) {
-            if (!anyLegalFortify(current)) IO::println("No legal fortify moves.");
-            else if (IO::readYesNo("Fortify?") == 'y') {
-                auto f = IO::readFortifyChoice(board_, current);
-                Rules::moveAfterCapture(board_, f.from, f.to, f.amount);
+void Game::closeTurn(View& view) {
+    pending_ = Decision{};
+    if (endTurn(view) == GameState::Ongoing) nextTurn(view);
+}
+
+GameState Game::beginTurn(View& view) {
+    using std::to_string;
+    if (status_ != GameState::Ongoing) return status_;
+    // Ownership keys seen at the start of a turn. A key is counted only
+    // if something was captured since that side's previous turn, so quiet
+    // stretches are left to kMaxStale and only real revisits count.
+    // Checked before the turn is counted: a turn that ends the game here
+    // is never played, recorded or logged.
+    if (repetitionLimit_ > 0) {
+        bool& fresh = capturedSince_[static_cast<int>(current_)];
+        if (fresh) {
+            fresh = false;
+            if (++seen_[board_.ownershipHash(current_)] >= repetitionLimit_) {
+                view.message("Position repeated. Draw.");
+                return status_ = GameState::Draw;
             }
-        } else {
-            auto plan = RandomAI::chooseFortify(board_, current, seed_++);
-            if (plan.valid) Rules::moveAfterCapture(board_, plan.from, plan.to, plan.amount);
         }
+    }
 
-        IO::printBoardColor(board_, 3);
+    if (++turns_ > kMaxTurns) return status_ = GameState::Draw;
+
+    if (recorder_) recorder_->turn(turns_, current_, board_);
+    if (telemetry_) telemetry_->turn(turns_, current_, board_);
+    dice_ = rng_.split(static_cast<std::uint64_t>(turns_));
+    captured_ = false;
+    view.message(current_ == PlayerId::P1 ? "\n-- Player 1 turn --" : "\n-- Player 2 turn --");
+    view.showBoard(board_);
+
+    MR_ENTER_PHASE(kReinforcePhase);
+    MR_TIME_PHASE(kReinforcePhase);
+    base_ = Rules::baseReinforcements(board_, current_);
+    TerrId bonusT = -1;
+    if (Rules::chainOf5BonusTarget(board_, current_, bonusT)) {
+        board_.addArmies(bonusT, 5);
+        if (recorder_) recorder_->reinforce(bonusT, 5);
+        if (telemetry_) telemetry_->bonus(5);
+        if (view.enabled())
+            view.message((current_ == PlayerId::P1 ? "P1" : "P2") +
+                         std::string(" chain bonus: +5 to ") + board_.name(bonusT));
+    }
+    return status_;
+}
 
-        // ---------- End of turn ----------
-        status = Rules::gameStatus(board_);
-        if (status != GameState::Ongoing) break;
+bool Game::reinforce(TerrId where) {
+    if (base_ <= 0 || where < 0 || where >= board_.count() || board_.owner(where) != current_)
+        return false;
+    board_.addArmies(where, base_);
+    if (recorder_) recorder_->reinforce(where, base_);
+    if (telemetry_) telemetry_->reinforce(base_);
+    base_ = 0;
+    return true;
+}
 
-        stale = captured ? 0 : stale + 1;
-        if (stale >= MAX_STALE) { status = GameState::Draw; break; }
+bool Game::attack(TerrId from, TerrId to, bool blitz, View& view) {
+    using std::to_string;
+    Rules::BattleLosses loss{};
+    bool took = blitz
+        ? Rules::applyBlitz(board_, from, to, current_, dice_, &loss)
+        : Rules::applyBattle(board_, from, to, current_, dice_, &loss);
+    if (recorder_ && loss.attacker + loss.defender > 0) {
+        if (blitz) recorder_->blitz(from, to, loss.attacker, loss.defender);
+        else recorder_->battle(from, to, loss.attacker, loss.defender);
+    }
+    if (telemetry_ && loss.attacker + loss.defender > 0)
+        telemetry_->battle(from, to, blitz ? 0 : 1, loss.attacker, loss.defender, took);
 
-        current = nextPlayer(current);
+    if (view.enabled()) {
+        view.message("Battle: attacker -" + to_string(loss.attacker) +
+                     ", defender -" + to_string(loss.defender));
+        view.showBoard(board_);
     }
 
-    IO::println("\n=== Final Board ===");
-    IO::printBoardColor(board_, 3);
-    return status;
+    if (took) captured_ = true;
+    status_ = Rules::gameStatus(board_);
+    lastBattle_ = loss;
+    return took;
+}
+
+void Game::moveIn(TerrId from, TerrId to, int amount, View& view) {
+    const int before = board_.armies(from);
+    Rules::moveAfterCapture(board_, from, to, amount);
+    if (recorder_ && before != board_.armies(from))
+        recorder_->captureMove(from, to, before - board_.armies(from));
+    view.showBoard(board_);
+}
+
+void Game::fortify(TerrId from, TerrId to, int amount) {
+    const int before = board_.armies(from);
+    Rules::moveAfterCapture(board_, from, to, amount);
+    if (recorder_ && before != board_.armies(from))
+        recorder_->fortify(from, to, before - board_.armies(from));
+}
+
+GameState Game::endTurn(View& view) {
+    view.showBoard(board_);
+    status_ = Rules::gameStatus(board_);
+    if (status_ != GameState::Ongoing) return status_;
+
+    if (captured_) capturedSince_[0] = capturedSince_[1] = true;
+    stale_ = captured_ ? 0 : stale_ + 1;
+    if (stale_ >= kMaxStale) return status_ = GameState::Draw;
+
+    current_ = current_ == PlayerId::P1 ? PlayerId::P2 : PlayerId::P1;
+    return status_;
+}
+
+GameState Game::finish(View& view) {
+    turns_ = std::min(turns_, kMaxTurns);
+    if (recorder_) recorder_->finish(status_, turns_);
+    if (telemetry_) telemetry_->finish(status_, turns_, board_);
+    if (Instrument::kEnabled && Instrument::dumpAtGameEnd()) Instrument::dump(std::cerr);
+    view.message("\n=== Final Board ===");
+    view.showBoard(board_);
+    return status_;
 }
@@ -1,9 +1,19 @@
 #pragma once
 #include <cstdint>
-#include <random>
+#include <memory>
+#include <unordered_map>
 #include "src/Board.h"
+#include "src/MapSpec.h"
+#include "src/MapTopology.h"
+#include "src/Rng.h"
+#include "src/Rules.h"
 #include "src/Types.h"
 
+class Controller;
+class GameRecorder;
+class View;
+namespace Telemetry { class GameLog; }
+
 // ------------------------------------------------------------
 // Game
 //  • Manages a full Mini-RISK match
@@ -11,19 +21,83 @@
 // ------------------------------------------------------------
 class Game {
 public:
+    // Optional adjudication: a turn starting on the same ownership map,
+    // same side to move, for the n-th time after captures (a capture /
+    // recapture cycle) ends in a draw. Exact positions cannot repeat
+    // here since reinforcements only add armies.
+    static constexpr int kRepetitionLimit = 0;   // off
+    static constexpr int kMaxTurns = 500;        // then a draw
+    static constexpr int kMaxStale = 60;         // turns without a capture, then a draw
+
     // ---------- Constructors ----------
     Game();                                   // random seed
     explicit Game(uint32_t seed);             // fixed seed for reproducibility
+    Game(uint32_t seed, int territories);     // generated map of any size
+    Game(std::shared_ptr<const MapTopology> map, uint32_t seed);   // every board on `map`;
+                                                                   // seed = the one `map` was built from
 
     // ---------- Core Methods ----------
     void printRules() const;                  // show basic rules
     void setupStartingPositions(uint32_t seed = 0);
     void resetBoard(uint32_t seed);           // rebuild board with new seed
-    GameState play(bool cpuAsP2 = true);      // run one full game
+    void setBattleSeed(uint32_t seed);        // re-key the battle dice stream
+    void setRepetitionLimit(int n);           // draw on n-th repeat (0 = off)
+    void setRecorder(GameRecorder* r);        // log the next play() (nullptr = off)
+    void setTelemetry(Telemetry::GameLog* t); // statistics of the next play() (nullptr = off)
+    void setBlitz(bool on);                   // each attack fights to the end (Rules::applyBlitz)
+    GameState play(bool cpuAsP2 = true);      // run one full game (console)
+    GameState play(Controller& p1, Controller& p2, View& view);  // any players / output
+
+    // ---------- Step engine ----------
+    // The turn flow as a resumable state machine. start() runs to the
+    // first decision; pendingDecision() says who must decide what, and
+    // step() applies the answer and runs on to the next decision or the
+    // end of the game. Nothing blocks and all turn state lives in the
+    // Game, so one thread can interleave any number of games and take
+    // the answers from anywhere: play() asks Controllers (answer()),
+    // the socket server asks its clients.
+    enum class DecisionKind { None, Reinforce, Attack, Move, Fortify };
+
+    struct Decision {
+        DecisionKind kind{DecisionKind::None};   // None = game over, see status()
+        PlayerId player{PlayerId::None};
+        int amount{0};                // Reinforce: armies to place; Move: most that may move
+        int attacks{0};               // Attack: battles already fought this turn
+        TerrId from{-1}, to{-1};      // Move: the capture being filled
+    };
+
+    struct Action {
+        bool pass{false};             // Reinforce: forfeit; Attack: stop; Fortify: skip
+        TerrId from{-1}, to{-1};      // Reinforce: `to` receives the armies
+        int amount{0};                // Move / Fortify
+        bool blitz{false};            // Attack: fight to the end even without setBlitz
+
+        static Action stop()                            { Action a; a.pass = true; return a; }
+        static Action place(TerrId t)                   { Action a; a.to = t; return a; }
+        static Action attack(TerrId f, TerrId t, bool blitz = false) {
+            Action a; a.from = f; a.to = t; a.blitz = blitz; return a;
+        }
+        static Action move(int n)                       { Action a; a.amount = n; return a; }
+        static Action fortify(TerrId f, TerrId t, int n) {
+            Action a; a.from = f; a.to = t; a.amount = n; return a;
+        }
+    };
+
+    void start(View& view);                   // new match on the current board
+    const Decision& pendingDecision() const;
+    bool step(const Action& a, View& view);   // false = not legal now, nothing changed
+    void answer(Controller& ctl, View& view); // the pending decision, from ctl
+    GameState playTurn(Controller& ctl, View& view);   // answer() until the other side is asked
+    void adjudicate(GameState result, View& view);     // end now, e.g. on a solved endgame
+    GameState finish(View& view);             // close the record, show the final board
 
     // ---------- Accessors ----------
     Board& board();
     const Board& board() const;
+    int turnsPlayed() const;                  // turns taken by the last play()
+    PlayerId toMove() const;
+    GameState status() const;
+    const Rules::BattleLosses& lastBattle() const;   // of the last Attack step
 
 private:
     // ---------- Helpers ----------
@@ -31,9 +105,38 @@ private:
     bool anyLegalAttack(PlayerId p) const;
     bool anyLegalFortify(PlayerId p) const;
 
+    // ---------- Turn flow (step engine internals) ----------
+    GameState beginTurn(View& view);          // Ongoing = the side to move acts
+    bool reinforce(TerrId where);             // all of base_ on one owned territory
+    bool attack(TerrId from, TerrId to, bool blitz, View& view);   // true = captured
+    void moveIn(TerrId from, TerrId to, int amount, View& view);
+    void fortify(TerrId from, TerrId to, int amount);
+    GameState endTurn(View& view);
+    void nextTurn(View& view);                // begin a turn, up to its Reinforce decision
+    void enterAttack(View& view, bool first); // next Attack decision, or on to fortify
+    void enterFortify(View& view);
+    void closeTurn(View& view);               // end the turn, begin the next
+
     // ---------- Members ----------
     Board board_;
     PlayerId current_{PlayerId::P1};
     uint32_t seed_{0};
-    std::mt19937 rng_;
+    int turns_{0};
+    GameState status_{GameState::Ongoing};
+    int stale_{0};                            // turns since the last capture
+    std::unordered_map<std::uint64_t, int> seen_;   // repetition: ownership key -> count
+    bool capturedSince_[2]{true, true};       // per side, since its previous turn
+    bool captured_{false};                    // this turn
+    int base_{0};                             // reinforcements not yet placed
+    Rng::Stream dice_;                        // this turn's battles
+    Decision pending_;
+    int attacks_{0};                          // battles this turn
+    Rules::BattleLosses lastBattle_{};
+    int territories_{MapSpec::kDefaultTerritories};
+    std::shared_ptr<const MapTopology> map_;  // fixed map (else generated per seed)
+    int repetitionLimit_{kRepetitionLimit};
+    GameRecorder* recorder_{nullptr};         // not owned
+    Telemetry::GameLog* telemetry_{nullptr};  // not owned
+    bool blitz_{false};
+    Rng::Stream rng_;                         // battle dice, split per turn
 };
@@ -0,0 +1,408 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "Game.h"
+#include "src/BattleBatch.h"
+#include "src/Blitz.h"
+#include "src/Eval.h"
+#include "src/Instrument.h"
+#include "src/MapSpec.h"
+#include "src/RandomAI.h"
+#include "src/Rules.h"
+
+// ------------------------------------------------------------
+// bench — fixed-seed micro-benchmarks for the hot paths
+//  • Each benchmark is calibrated to a target time per sample,
+//    then timed over several samples: mean ns/op ± stddev, min
+//    and median
+//  • Heap allocations per op from Instrument's operator new hook
+//    (n/a when built with MINIRISK_INSTRUMENT=0)
+//  • Linux hardware counters (cycles, instructions, cache and
+//    branch misses) through perf_event_open when permitted
+//  • BattleBatch runs once per kernel the CPU supports
+//  • --json writes the same numbers for comparing runs
+// ------------------------------------------------------------
+
+namespace {
+
+// ---------- Hardware counters ----------
+class PerfCounters {
+public:
+    enum Event { kCycles, kInstructions, kCacheMisses, kBranchMisses, kCount };
+
+    PerfCounters() {
+        const std::uint64_t configs[kCount] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int e = 0; e < kCount; ++e) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof attr);
+            attr.size = sizeof attr;
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = (e == 0);            // the group starts with its leader
+            attr.exclude_kernel = 1;             // works under perf_event_paranoid 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1,
+                                               e == 0 ? -1 : fds_[0], 0));
+            if (fds_[e] < 0) { closeAll(); return; }
+        }
+    }
+    ~PerfCounters() { closeAll(); }
+
+    bool available() const { return fds_[0] >= 0; }
+
+    void start() {
+        if (!available()) return;
+        ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    // Stops the group and returns the counts, scaled up if the kernel
+    // multiplexed them; false if they could not be read.
+    bool stop(double out[kCount]) {
+        if (!available()) return false;
+        ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        std::uint64_t buf[3 + kCount];           // nr, enabled, running, values
+        if (read(fds_[0], buf, sizeof buf) != static_cast<ssize_t>(sizeof buf)) return false;
+        if (buf[0] != kCount || buf[2] == 0) return false;
+        const double scale = static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+        for (int e = 0; e < kCount; ++e) out[e] = static_cast<double>(buf[3 + e]) * scale;
+        return true;
+    }
+
+private:
+    void closeAll() {
+        for (int& fd : fds_) {
+            if (fd >= 0) close(fd);
+            fd = -1;
+        }
+    }
+
+    int fds_[kCount] = {-1, -1, -1, -1};
+};
+
+// ---------- Harness ----------
+template <class T>
+inline void keep(const T& v) { asm volatile("" : : "r"(&v) : "memory"); }
+
+struct Options {
+    int samples{15};
+    double sampleMs{20.0};
+    std::string filter;                          // substring; empty = all
+    std::string json;                            // file, "-" = stdout
+};
+
+struct Result {
+    std::string name;
+    std::uint64_t opsPerSample{0};
+    double meanNs{0}, stddevNs{0}, minNs{0}, medianNs{0};
+    double allocsPerOp{0}, bytesPerOp{0};
+    bool counters{false};
+    double perOp[PerfCounters::kCount]{};
+};
+
+using Op = std::function<void(std::uint64_t i)>;
+
+double timeOps(const Op& op, std::uint64_t first, std::uint64_t n) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < n; ++i) op(first + i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+Result run(const std::string& name, const Op& op, const Options& o, PerfCounters& perf) {
+    Result r;
+    r.name = name;
+
+    // Calibrate: double the batch until one sample takes sampleMs.
+    std::uint64_t n = 1, i = 0;
+    const double target = o.sampleMs * 1e6;
+    for (;;) {
+        double ns = timeOps(op, i, n);
+        i += n;
+        if (ns >= target || n >= (1ull << 32)) break;
+        n = ns < target / 16 ? n * 8 : n * 2;
+    }
+    r.opsPerSample = n;
+
+    std::vector<double> perOp;
+    const std::uint64_t a0 = Instrument::total(Instrument::kAllocations);
+    const std::uint64_t b0 = Instrument::total(Instrument::kAllocBytes);
+    perf.start();
+    for (int s = 0; s < o.samples; ++s) {
+        perOp.push_back(timeOps(op, i, n) / static_cast<double>(n));
+        i += n;
+    }
+    double counts[PerfCounters::kCount];
+    r.counters = perf.stop(counts);
+    const double ops = static_cast<double>(n) * o.samples;
+    r.allocsPerOp = static_cast<double>(Instrument::total(Instrument::kAllocations) - a0) / ops;
+    r.bytesPerOp = static_cast<double>(Instrument::total(Instrument::kAllocBytes) - b0) / ops;
+    if (r.counters)
+        for (int e = 0; e < PerfCounters::kCount; ++e) r.perOp[e] = counts[e] / ops;
+
+    double sum = 0;
+    for (double v : perOp) sum += v;
+    r.meanNs = sum / perOp.size();
+    double var = 0;
+    for (double v : perOp) var += (v - r.meanNs) * (v - r.meanNs);
+    r.stddevNs = perOp.size() > 1 ? std::sqrt(var / (perOp.size() - 1)) : 0.0;
+    std::sort(perOp.begin(), perOp.end());
+    r.minNs = perOp.front();
+    r.medianNs = perOp[perOp.size() / 2];
+    return r;
+}
+
+// ---------- Fixtures ----------
+constexpr std::uint32_t kSeed = 20240601u;
+
+// The default map after the deal, with 1–9 armies everywhere (a mid-game spread).
+Board midGameBoard() {
+    Game g(kSeed);
+    g.setupStartingPositions(kSeed);
+    Board b = g.board();
+    Rng::Stream rng(kSeed);
+    for (TerrId t = 0; t < b.count(); ++t) b.addArmies(t, static_cast<int>(rng.below(9)));
+    return b;
+}
+
+// ---------- Output ----------
+void printTable(const std::vector<Result>& rs, bool counters) {
+    int nameW = 28;
+    for (const auto& r : rs) nameW = std::max(nameW, static_cast<int>(r.name.size()) + 2);
+    std::cout << std::left << std::setw(nameW) << "benchmark" << std::right
+              << std::setw(12) << "ns/op" << std::setw(8) << "±%"
+              << std::setw(12) << "min" << std::setw(10) << "allocs";
+    if (counters)
+        std::cout << std::setw(10) << "cycles" << std::setw(7) << "IPC"
+                  << std::setw(10) << "cache-m" << std::setw(10) << "br-miss";
+    std::cout << "\n" << std::fixed;
+    for (const auto& r : rs) {
+        const double rel = r.meanNs > 0 ? 100.0 * r.stddevNs / r.meanNs : 0.0;
+        std::cout << std::left << std::setw(nameW) << r.name << std::right << std::setprecision(1)
+                  << std::setw(12) << r.meanNs << std::setw(8) << rel
+                  << std::setw(12) << r.minNs << std::setprecision(2) << std::setw(10);
+        if (Instrument::kEnabled) std::cout << r.allocsPerOp;
+        else std::cout << "n/a";
+        if (counters && r.counters) {
+            const double* c = r.perOp;
+            const double ipc = c[PerfCounters::kCycles] > 0
+                ? c[PerfCounters::kInstructions] / c[PerfCounters::kCycles] : 0.0;
+            std::cout << std::setprecision(0) << std::setw(10) << c[PerfCounters::kCycles]
+                      << std::setprecision(2) << std::setw(7) << ipc
+                      << std::setw(10) << c[PerfCounters::kCacheMisses]
+                      << std::setw(10) << c[PerfCounters::kBranchMisses];
+        }
+        std::cout << "\n";
+    }
+    if (!counters) std::cout << "(hardware counters unavailable: perf_event_open refused)\n";
+}
+
+void writeJson(std::FILE* f, const std::vector<Result>& rs, const Options& o) {
+    static const char* kNames[PerfCounters::kCount] = {
+        "cycles", "instructions", "cache_misses", "branch_misses"};
+    std::fprintf(f, "{\n  \"seed\": %u,\n  \"samples\": %d,\n  \"sample_ms\": %.3f,\n  \"benchmarks\": [\n",
+                 kSeed, o.samples, o.sampleMs);
+    for (size_t k = 0; k < rs.size(); ++k) {
+        const Result& r = rs[k];
+        std::fprintf(f,
+                     "    {\"name\": \"%s\", \"ops_per_sample\": %llu, \"ns_per_op\": %.3f, "
+                     "\"stddev_ns\": %.3f, \"min_ns\": %.3f, \"median_ns\": %.3f, "
+                     "\"allocs_per_op\": ",
+                     r.name.c_str(), static_cast<unsigned long long>(r.opsPerSample), r.meanNs,
+                     r.stddevNs, r.minNs, r.medianNs);
+        if (Instrument::kEnabled)
+            std::fprintf(f, "%.4f, \"alloc_bytes_per_op\": %.2f", r.allocsPerOp, r.bytesPerOp);
+        else
+            std::fprintf(f, "null, \"alloc_bytes_per_op\": null");
+        for (int e = 0; e < PerfCounters::kCount; ++e) {
+            if (r.counters) std::fprintf(f, ", \"%s_per_op\": %.3f", kNames[e], r.perOp[e]);
+            else std::fprintf(f, ", \"%s_per_op\": null", kNames[e]);
+        }
+        std::fprintf(f, "}%s\n", k + 1 < rs.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+}
+
+void usage() {
+    std::cout
+        << "Usage: bench [options]\n"
+        << "  -n <samples>   timed samples per benchmark (default 15)\n"
+        << "  -t <ms>        target time per sample (default 20)\n"
+        << "  -b <filter>    only benchmarks whose name contains <filter>\n"
+        << "  --json <file>  also write results as JSON (\"-\" = stdout)\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-h" || a == "--help") { usage(); return false; }
+        if (a != "-n" && a != "-t" && a != "-b" && a != "--json") {
+            std::cerr << "Unknown option: " << a << "\n";
+            usage();
+            return false;
+        }
+        if (i + 1 >= argc) { std::cerr << "Missing value for " << a << "\n"; return false; }
+        const char* v = argv[++i];
+        if (a == "-n") o.samples = std::atoi(v);
+        else if (a == "-t") o.sampleMs = std::atof(v);
+        else if (a == "-b") o.filter = v;
+        else o.json = v;
+    }
+    return o.samples > 0 && o.sampleMs > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 1;
+
+    Board board = midGameBoard();
+    const int n = board.count();
+    const PlayerId p1 = PlayerId::P1;
+
+    // Attack and fortify pairs that are legal on the fixture.
+    std::vector<std::pair<TerrId, TerrId>> attacks, paths;
+    for (TerrId a = 0; a < n; ++a)
+        for (TerrId b = 0; b < n; ++b) {
+            if (board.owner(a) != p1 || a == b) continue;
+            if (board.owner(b) != p1 && board.areAdjacent(a, b)) attacks.emplace_back(a, b);
+            if (board.owner(b) == p1) paths.emplace_back(a, b);
+        }
+    for (TerrId a : Rules::owned(board, p1)) board.addArmies(a, 2);   // every attack can roll
+    Board battleBoard = board;
+    battleBoard.beginRecording();
+    Rng::Stream dice(kSeed);
+
+    // Batch buffers: every dice combination, and equal 10-vs-8 battles.
+    constexpr std::size_t kBatch = 4096;
+    std::vector<std::uint8_t> attDice(kBatch), defDice(kBatch), attLoss(kBatch), defLoss(kBatch);
+    for (std::size_t i = 0; i < kBatch; ++i) {
+        attDice[i] = static_cast<std::uint8_t>(1 + i % 3);
+        defDice[i] = static_cast<std::uint8_t>(1 + (i / 3) % 2);
+    }
+    std::vector<std::int32_t> attArmies(kBatch), defArmies(kBatch);
+
+    std::vector<std::pair<std::string, Op>> benches = {
+        {"MapSpec::build20", [](std::uint64_t i) {
+            auto terrs = MapSpec::build20(kSeed + static_cast<unsigned>(i));
+            keep(terrs);
+        }},
+        {"Board::renderColor", [&](std::uint64_t) {
+            std::string s = board.renderColor();
+            keep(s);
+        }},
+        {"Rules::owned", [&](std::uint64_t i) {
+            auto v = Rules::owned(board, (i & 1) ? PlayerId::P2 : p1);
+            keep(v);
+        }},
+        {"Rules::borders", [&](std::uint64_t i) {
+            auto v = Rules::borders(board, (i & 1) ? PlayerId::P2 : p1);
+            keep(v);
+        }},
+        {"Rules::gameStatus", [&](std::uint64_t) {
+            GameState s = Rules::gameStatus(board);
+            keep(s);
+        }},
+        {"Rules::chainOf5BonusTarget", [&](std::uint64_t i) {
+            TerrId t = -1;
+            bool ok = Rules::chainOf5BonusTarget(board, (i & 1) ? PlayerId::P2 : p1, t);
+            keep(ok);
+            keep(t);
+        }},
+        {"Rules::canFortifyPath", [&](std::uint64_t i) {
+            const auto& pr = paths[i % paths.size()];
+            bool ok = Rules::canFortifyPath(board, pr.first, pr.second, p1);
+            keep(ok);
+        }},
+        {"Rules::simulateBattleOnce", [&](std::uint64_t i) {
+            auto l = Rules::simulateBattleOnce(1 + static_cast<int>(i % 3), 1 + static_cast<int>(i & 1), dice);
+            keep(l);
+        }},
+        {"Rules::applyBattle+undo", [&](std::uint64_t i) {
+            const auto& pr = attacks[i % attacks.size()];
+            const int mark = battleBoard.undoMark();
+            bool took = Rules::applyBattle(battleBoard, pr.first, pr.second, p1, dice);
+            keep(took);
+            battleBoard.undoTo(mark);
+        }},
+        {"Rules::applyBlitz+undo", [&](std::uint64_t i) {
+            const auto& pr = attacks[i % attacks.size()];
+            const int mark = battleBoard.undoMark();
+            bool took = Rules::applyBlitz(battleBoard, pr.first, pr.second, p1, dice);
+            keep(took);
+            battleBoard.undoTo(mark);
+        }},
+        {"Blitz::resolve 1000v1000", [&](std::uint64_t) {
+            auto r = Blitz::resolve(1000, 1000, dice);
+            keep(r);
+        }},
+        {"Eval::evaluate x128", [&](std::uint64_t i) {
+            Eval::Config cfg;
+            cfg.seed = i;
+            auto e = Eval::evaluate(board, (i & 1) ? PlayerId::P2 : p1, cfg);
+            keep(e);
+        }},
+        {"RandomAI::chooseAttack", [&](std::uint64_t i) {
+            auto plan = RandomAI::chooseAttack(board, (i & 1) ? PlayerId::P2 : p1,
+                                               kSeed + static_cast<std::uint32_t>(i));
+            keep(plan);
+        }},
+        {"RandomAI::chooseFortify", [&](std::uint64_t i) {
+            auto plan = RandomAI::chooseFortify(board, (i & 1) ? PlayerId::P2 : p1,
+                                                kSeed + static_cast<std::uint32_t>(i));
+            keep(plan);
+        }},
+    };
+
+    for (BattleBatch::Isa isa : {BattleBatch::Isa::Scalar, BattleBatch::Isa::Avx2, BattleBatch::Isa::Avx512}) {
+        if (!BattleBatch::supported(isa)) continue;
+        const std::string tag = std::string("/") + BattleBatch::name(isa) + " x" + std::to_string(kBatch);
+        benches.emplace_back("BattleBatch::rounds" + tag, [&, isa](std::uint64_t) {
+            BattleBatch::setIsa(isa);
+            BattleBatch::rounds(attDice.data(), defDice.data(), attLoss.data(), defLoss.data(),
+                                kBatch, dice);
+            keep(attLoss);
+        });
+        benches.emplace_back("BattleBatch::battles" + tag, [&, isa](std::uint64_t i) {
+            BattleBatch::setIsa(isa);
+            std::fill(attArmies.begin(), attArmies.end(), 10);
+            std::fill(defArmies.begin(), defArmies.end(), 8);
+            auto fought = BattleBatch::battles(attArmies.data(), defArmies.data(), kBatch, dice, i * kBatch);
+            keep(fought);
+        });
+    }
+
+    PerfCounters perf;
+    std::vector<Result> results;
+    for (const auto& [name, op] : benches) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) continue;
+        results.push_back(run(name, op, opt, perf));
+    }
+    if (results.empty()) { std::cerr << "No benchmark matches \"" << opt.filter << "\"\n"; return 1; }
+
+    printTable(results, perf.available());
+    if (!opt.json.empty()) {
+        std::FILE* f = opt.json == "-" ? stdout : std::fopen(opt.json.c_str(), "w");
+        if (!f) { std::cerr << "Cannot write " << opt.json << "\n"; return 1; }
+        writeJson(f, results, opt);
+        if (f != stdout) std::fclose(f);
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "src/Endgame.h"
+#include "src/MapSpec.h"
+#include "src/MapTopology.h"
+#include "src/Utils.h"
+
+// ------------------------------------------------------------
+// endgame — build or inspect an endgame table (see Endgame.h)
+//  • endgame -o <file> [options]   solve every position of one map
+//  • endgame <file> [options]      header; with -m/-s/-t, whether
+//                                  it belongs to that map
+// ------------------------------------------------------------
+namespace {
+
+struct Options {
+    std::string out;              // build into this file
+    std::string in;               // or inspect this one
+    int territories{6};
+    std::uint32_t mapSeed{1};
+    bool mapGiven{false};
+    int maxArmies{6};
+    int horizon{2};
+    bool blitz{false};
+};
+
+void usage() {
+    std::cout
+        << "Usage: endgame -o <file> [options] | endgame <file> [options]\n"
+        << "  -o <file>      build a table into <file>\n"
+        << "  -m <n>         territories (default 6, at most "
+        << Endgame::Table::kMaxTerritories << ")\n"
+        << "  -s <seed>      map seed, as for MapSpec::build (default 1)\n"
+        << "  -t <seed>      the map of `tournament -f -s <seed> -m <n>`\n"
+        << "  -a <n>         most armies per territory covered (default 6)\n"
+        << "  -H <turns>     horizon in turns of both sides (default 2)\n"
+        << "  -z             blitz battles (as tournament -z)\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "-h" || a == "--help") { usage(); return false; }
+        if (a == "-z") { o.blitz = true; continue; }
+        if (a[0] != '-') { o.in = a; continue; }
+        if (a != "-o" && a != "-m" && a != "-s" && a != "-t" && a != "-a" && a != "-H") {
+            std::cerr << "Unknown option: " << a << "\n";
+            usage();
+            return false;
+        }
+        if (!(v = next())) { std::cerr << "Missing value for " << a << "\n"; return false; }
+        if (a == "-o") o.out = v;
+        else if (a == "-m") o.territories = std::atoi(v);
+        else if (a == "-a") o.maxArmies = std::atoi(v);
+        else if (a == "-H") o.horizon = std::atoi(v);
+        else if (a == "-s") { o.mapSeed = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10)); o.mapGiven = true; }
+        else if (a == "-t") { o.mapSeed = deriveSeed(std::strtoull(v, nullptr, 10), 0, 0); o.mapGiven = true; }
+    }
+    if (o.out.empty() == o.in.empty()) { usage(); return false; }
+    return true;
+}
+
+int inspect(const Options& o) {
+    Endgame::Table t;
+    if (!t.open(o.in)) {
+        std::cerr << "Not an endgame table: " << o.in << "\n";
+        return 1;
+    }
+    std::cout << "Map:       " << t.territories() << " territories, key "
+              << std::hex << t.mapKey() << std::dec << "\n"
+              << "Covers:    1.." << t.maxArmies() << " armies per territory, "
+              << t.horizon() << (t.horizon() == 1 ? " turn" : " turns")
+              << (t.blitz() ? ", blitz" : "") << "\n";
+    if (o.mapGiven) {
+        auto map = MapTopology::make(MapSpec::build(t.territories(), o.mapSeed));
+        const bool same = Endgame::topologyKey(*map) == t.mapKey();
+        std::cout << "Map seed " << o.mapSeed << ": " << (same ? "matches" : "does not match") << "\n";
+        return same ? 0 : 1;
+    }
+    return 0;
+}
+
+int build(const Options& o) {
+    if (o.territories < 2 || o.territories > Endgame::Table::kMaxTerritories ||
+        o.maxArmies < 1 || o.maxArmies > 255 || o.horizon < 1 || o.horizon > 16) {
+        std::cerr << "Out of range: at most " << Endgame::Table::kMaxTerritories
+                  << " territories, 1..255 armies, 1..16 turns\n";
+        return 1;
+    }
+    auto map = MapTopology::make(MapSpec::build(o.territories, o.mapSeed));
+    Endgame::Config cfg;
+    cfg.horizon = o.horizon;
+    cfg.blitz = o.blitz;
+
+    auto t0 = std::chrono::steady_clock::now();
+    const std::size_t solved = Endgame::Table::build(map, o.maxArmies, cfg, o.out);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!solved) {
+        std::cerr << "Cannot write " << o.out << "\n";
+        return 1;
+    }
+    std::cout << std::fixed << std::setprecision(1)
+              << "Solved:    " << solved << " positions in " << secs << " s\n"
+              << "Map:       seed " << o.mapSeed << ", " << o.territories << " territories, key "
+              << std::hex << Endgame::topologyKey(*map) << std::dec << "\n"
+              << "Wrote:     " << o.out << "\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 1;
+    return opt.in.empty() ? build(opt) : inspect(opt);
+}
@@ -1,16 +1,37 @@
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <string>
 #include "Game.h"
 #include "src/IO.h"
+#include "src/Telemetry.h"
 
-int main() {
+// Buffered telemetry rows before they are written out: a few games
+// lost if the program is killed, instead of a tiny chunk per game.
+constexpr std::size_t kFlushRows = 1024;
+
+// Usage: minirisk [telemetry file]   (append each game's statistics; see telemetry)
+int main(int argc, char** argv) {
     // Create a Game object — this will manage its own board and RNG
     Game game;
 
+    std::unique_ptr<Telemetry::Sink> sink;
+    Telemetry::GameLog log;
+    if (argc > 1) {
+        sink = std::make_unique<Telemetry::Sink>(argv[1]);
+        if (!sink->ok()) {
+            IO::println(std::string("Cannot append telemetry to ") + argv[1]);
+            return 1;
+        }
+        game.setTelemetry(&log);
+    }
+
     // Print the rules (non-static call)
     game.printRules();
 
     // Play-again loop
+    std::uint64_t games = 0;
     for (;;) {
         std::random_device rd;
         std::uint32_t seed = rd();
@@ -22,6 +43,10 @@ int main() {
         bool cpuAsP2 = true;
 
         GameState result = game.play(cpuAsP2);
+        if (sink) {
+            sink->add(games++, log);
+            if (sink->bufferedRows() >= kFlushRows) sink->flush();
+        }
 
         switch (result) {
             case GameState::Player1Wins: IO::println("Result: Player 1 wins!"); break;
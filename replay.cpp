@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "src/Board.h"
+#include "src/Eval.h"
+#include "src/GameRecord.h"
+#include "src/IO.h"
+#include "src/ThreadPool.h"
+
+// ------------------------------------------------------------
+// replay — inspect a binary game record (see GameRecord.h)
+//  • replay <file>         summary: map, result, turns, keyframes
+//  • replay <file> <turn>  board at the start of that turn
+//  • replay <file> <turn> <rollouts>
+//                          ... and who is winning there (Eval)
+// ------------------------------------------------------------
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 4) {
+        std::cerr << "Usage: replay <file.mrr> [turn [rollouts]]\n";
+        return 1;
+    }
+
+    GameReader rec;
+    if (!rec.open(argv[1])) {
+        std::cerr << "Not a readable game record: " << argv[1] << "\n";
+        return 1;
+    }
+
+    const char* result = rec.result() == GameState::Player1Wins ? "Player 1 wins"
+                       : rec.result() == GameState::Player2Wins ? "Player 2 wins"
+                       : rec.result() == GameState::Draw        ? "Draw"
+                                                                : "Unfinished";
+    std::cout << "Map:       seed " << rec.mapSeed() << ", " << rec.territories() << " territories\n"
+              << "Result:    " << result << " after " << rec.turns() << " turns\n"
+              << "Keyframes: " << rec.keyframeCount() << " (every "
+              << rec.keyframeInterval() << " turns)\n";
+    if (argc == 2) return 0;
+
+    const int turn = std::atoi(argv[2]);
+    Board b(std::vector<Territory>{});
+    PlayerId toMove = PlayerId::None;
+    if (!rec.seek(turn, b, toMove)) {
+        std::cerr << "No turn " << argv[2] << " in this record\n";
+        return 1;
+    }
+    std::cout << "\nTurn " << turn << ", "
+              << (toMove == PlayerId::P1 ? "Player 1" : "Player 2") << " to move\n";
+    IO::printBoardColor(b);
+    if (argc == 3 || b.status() != GameState::Ongoing) return 0;
+
+    ThreadPool pool;
+    Eval::Config cfg;
+    cfg.samples = std::max(2, std::atoi(argv[3]));
+    cfg.pool = &pool;
+    const Eval::Estimate e = Eval::evaluate(b, toMove, cfg);
+    std::cout << std::fixed << std::setprecision(1)
+              << "\nEstimate:  " << 100.0 * e.win << "% win, " << 100.0 * e.draw << "% draw, "
+              << 100.0 * e.loss << "% loss for the side to move (" << e.samples << " rollouts)\n"
+              << std::setprecision(3)
+              << "Score:     " << e.score << " ± " << e.halfWidth << "\n";
+    return 0;
+}
@@ -0,0 +1,579 @@
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Game.h"
+#include "src/Controller.h"
+#include "src/MCTS.h"
+#include "src/Rules.h"
+#include "src/ThreadPool.h"
+#include "src/View.h"
+
+// ------------------------------------------------------------
+// server — many concurrent matches behind one Unix socket
+//  • One epoll loop owns every connection and every Game; each
+//    connection plays one match at a time, as Player 1 against a
+//    CPU Player 2
+//  • Line protocol (kHelp). Each match is a Game step engine:
+//    commands become Game::Actions, and what the Game waits for
+//    next (pendingDecision) becomes the prompt. Moves the Rules
+//    refuse are answered with ERR and change nothing
+//  • CPU turns run on a ThreadPool; a worker hands the match back
+//    to the loop through an eventfd. Commands that arrive in the
+//    meantime wait in the connection's input buffer
+//  • After each action only the territories that changed are sent
+// ------------------------------------------------------------
+namespace {
+
+const char* const kHelp =
+    "# client -> server (one command per line)\n"
+    "#   NEW [seed] [territories]   start a match; you are player 1 and move first\n"
+    "#   PLACE <t>                  all reinforcements on your territory t\n"
+    "#   ATTACK <from> <to>         one battle\n"
+    "#   BLITZ <from> <to>          fight until capture or one attacker is left\n"
+    "#   MOVE <n>                   armies into the territory just captured\n"
+    "#   FORTIFY <from> <to> <n>    along your own territories; ends the turn\n"
+    "#   END                        end the turn\n"
+    "#   BOARD                      every territory again\n"
+    "#   HELP | QUIT\n"
+    "# server -> client: OK or ERR <reason> per command, then events\n"
+    "#   MAP <n>, then n x: N <id> <name> <neighbour ids...>\n"
+    "#   T <id> <owner 1|2> <armies>        a territory changed\n"
+    "#   BATTLE <from> <to> <att loss> <def loss>\n"
+    "#   TURN <n> <player>                  player 2 moves on its own\n"
+    "#   REINFORCE <n> | ATTACK | CAPTURED <from> <to> <max move> | FORTIFY\n"
+    "#                                      your move (FORTIFY: only FORTIFY / END left)\n"
+    "#   OVER <winner 1|2, 0 = draw>\n";
+
+constexpr int kMaxTerritories = 5000;            // NEW refuses larger maps
+constexpr std::size_t kMaxLine = 4096;           // longer input lines drop the client
+constexpr std::size_t kMaxInput = 4 * kMaxLine;  // buffered input; reading pauses at this
+constexpr std::size_t kMaxPending = 8u << 20;    // unsent output before a client is dropped
+constexpr std::uint64_t kListenTag = 0;          // epoll tags; sessions are numbered from 2
+constexpr std::uint64_t kWakeTag = 1;
+
+volatile std::sig_atomic_t gStop = 0;
+
+struct Options {
+    std::string path{"/tmp/minirisk.sock"};
+    unsigned threads{0};
+    std::string ai{"random"};
+    int territories{MapSpec::kDefaultTerritories};
+};
+
+void usage() {
+    std::cout
+        << "Usage: server [options]\n"
+        << "  -p <path>      Unix socket to listen on (default /tmp/minirisk.sock)\n"
+        << "  -j <threads>   workers for CPU turns (default: all cores)\n"
+        << "  -a <ai>        CPU player: random | mcts | mcts:<level> (default random)\n"
+        << "                 (levels: easy, normal, hard, analysis)\n"
+        << "  -m <n>         territories when NEW gives none (default "
+        << MapSpec::kDefaultTerritories << ")\n"
+        << "Connect with e.g. `socat - UNIX-CONNECT:/tmp/minirisk.sock` and send HELP.\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-h" || a == "--help") { usage(); return false; }
+        if (a != "-p" && a != "-j" && a != "-a" && a != "-m") {
+            std::cerr << "Unknown option: " << a << "\n";
+            usage();
+            return false;
+        }
+        if (i + 1 >= argc) { std::cerr << "Missing value for " << a << "\n"; return false; }
+        const char* v = argv[++i];
+        if (a == "-p") o.path = v;
+        else if (a == "-j") o.threads = static_cast<unsigned>(std::atoi(v));
+        else if (a == "-a") o.ai = v;
+        else if (a == "-m") o.territories = std::atoi(v);
+    }
+    return o.territories > 1 && o.territories <= kMaxTerritories;
+}
+
+// "random", "mcts" or "mcts:<difficulty>"
+std::unique_ptr<Controller> makeCpu(const std::string& ai, std::uint32_t seed) {
+    if (ai == "random") return std::make_unique<RandomAIController>(seed);
+    if (ai == "mcts") return std::make_unique<MCTSController>(seed);
+    Difficulty level;
+    if (ai.rfind("mcts:", 0) == 0 && parseDifficulty(ai.substr(5), level))
+        return std::make_unique<MCTSController>(seed, level);
+    return nullptr;
+}
+
+// ---------- Connections ----------
+using Kind = Game::DecisionKind;
+
+struct Session {
+    std::uint64_t id{0};                  // epoll tag and sessions_ key
+    int fd{-1};
+    std::string in, out;
+    std::unique_ptr<Game> game;
+    std::unique_ptr<Controller> cpu;
+    bool busy{false};                     // the Game is on a worker; hands off
+    std::vector<int> owner, armies;       // as last sent to the client
+    bool closing{false};                  // freed once no worker holds it
+    bool writing{false};                  // EPOLLOUT registered
+    bool reading{true};                   // EPOLLIN registered (off while busy or full)
+};
+
+void emit(Session& s, const std::string& line) {
+    s.out += line;
+    s.out += '\n';
+}
+
+// Whitespace-separated integers, all of them; false on anything else.
+bool readInts(std::istringstream& ss, std::vector<long long>& out) {
+    long long v;
+    while (ss >> v) out.push_back(v);
+    return ss.eof();
+}
+
+class Server {
+public:
+    explicit Server(const Options& o) : opt_(o), pool_(o.threads) {}
+    ~Server();
+
+    bool open();
+    void run();                           // until SIGINT / SIGTERM
+    unsigned workers() const { return pool_.size(); }
+
+private:
+    // ---------- Event loop ----------
+    void acceptAll();
+    void onEvent(std::uint64_t id, std::uint32_t events);
+    void onWake();
+    void receive(Session& s);
+    void serve(Session& s);               // run complete lines unless a CPU turn is out
+    void flush(Session& s);
+    void settle(std::uint64_t id);        // epoll interest, or free a closed session
+
+    // ---------- Protocol ----------
+    void command(Session& s, const std::string& line);
+    void newMatch(Session& s, const std::vector<long long>& a);
+    void prompt(Session& s);              // announce what the match waits for
+    void cpuTurn(Session& s);
+    void gameOver(Session& s);
+    void sendChanges(Session& s);
+
+    Options opt_;
+    int listenFd_{-1}, epollFd_{-1}, wakeFd_{-1};
+    std::uint64_t nextId_{2};
+    std::unordered_map<std::uint64_t, std::unique_ptr<Session>> sessions_;
+    std::uint64_t matches_{0};
+    NullView quiet_;
+
+    std::mutex doneM_;
+    std::vector<std::uint64_t> done_;     // sessions whose CPU turn returned
+    ThreadPool pool_;                     // last: joined before the sessions go
+};
+
+Server::~Server() {
+    pool_.wait();
+    for (auto& [id, s] : sessions_)
+        if (s->fd >= 0) ::close(s->fd);
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(opt_.path.c_str());
+    }
+    if (wakeFd_ >= 0) ::close(wakeFd_);
+    if (epollFd_ >= 0) ::close(epollFd_);
+}
+
+bool Server::open() {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (opt_.path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << opt_.path << "\n";
+        return false;
+    }
+    std::memcpy(addr.sun_path, opt_.path.c_str(), opt_.path.size() + 1);
+
+    // A socket left behind by an earlier run is replaced; anything else is not.
+    struct stat st{};
+    if (::lstat(opt_.path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) ::unlink(opt_.path.c_str());
+
+    auto fail = [](const char* what) {
+        std::cerr << "server: " << what << ": " << std::strerror(errno) << "\n";
+        return false;
+    };
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) return fail("socket");
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return fail(opt_.path.c_str());
+    }
+    if (::listen(listenFd_, SOMAXCONN) < 0) return fail("listen");
+
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0) return fail("epoll");
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kListenTag;
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &ev) < 0) return fail("epoll_ctl");
+    ev.data.u64 = kWakeTag;
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev) < 0) return fail("epoll_ctl");
+    return true;
+}
+
+void Server::run() {
+    std::vector<epoll_event> events(256);
+    while (!gStop) {
+        const int n = ::epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "server: epoll_wait: " << std::strerror(errno) << "\n";
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            const std::uint64_t tag = events[i].data.u64;
+            if (tag == kListenTag) acceptAll();
+            else if (tag == kWakeTag) onWake();
+            else onEvent(tag, events[i].events);
+        }
+    }
+    std::cout << "server: " << matches_ << " matches started, "
+              << sessions_.size() << " connections open at exit\n";
+}
+
+// ---------- Event loop ----------
+void Server::acceptAll() {
+    for (;;) {
+        const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                std::cerr << "server: accept: " << std::strerror(errno) << "\n";
+            return;
+        }
+        const std::uint64_t id = nextId_++;
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = id;
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            ::close(fd);
+            continue;
+        }
+        auto s = std::make_unique<Session>();
+        s->id = id;
+        s->fd = fd;
+        sessions_.emplace(id, std::move(s));
+    }
+}
+
+void Server::onEvent(std::uint64_t id, std::uint32_t events) {
+    auto it = sessions_.find(id);
+    if (it == sessions_.end()) return;
+    Session& s = *it->second;
+    if (s.fd < 0) return;
+    if (events & (EPOLLHUP | EPOLLERR)) s.closing = true;   // even with reading paused
+    else if (events & (EPOLLIN | EPOLLRDHUP)) receive(s);
+    serve(s);
+    flush(s);
+    settle(id);
+}
+
+void Server::onWake() {
+    std::uint64_t count;
+    while (::read(wakeFd_, &count, sizeof count) > 0) {}
+    std::vector<std::uint64_t> ready;
+    {
+        std::lock_guard<std::mutex> lk(doneM_);
+        ready.swap(done_);
+    }
+    for (std::uint64_t id : ready) {
+        auto it = sessions_.find(id);
+        if (it == sessions_.end()) continue;
+        Session& s = *it->second;
+        s.busy = false;
+        if (!s.closing) {
+            sendChanges(s);
+            prompt(s);
+            serve(s);
+            flush(s);
+        }
+        settle(id);
+    }
+}
+
+// Up to kMaxInput buffered; the rest waits in the socket until
+// serve() has used some (settle() pauses EPOLLIN meanwhile).
+void Server::receive(Session& s) {
+    char buf[4096];
+    while (s.in.size() < kMaxInput) {
+        const std::size_t room = std::min(sizeof buf, kMaxInput - s.in.size());
+        const ssize_t n = ::recv(s.fd, buf, room, 0);
+        if (n > 0) {
+            s.in.append(buf, static_cast<std::size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) s.closing = true;
+        return;
+    }
+}
+
+void Server::serve(Session& s) {
+    std::size_t pos = 0;
+    while (!s.closing && !s.busy) {
+        const std::size_t nl = s.in.find('\n', pos);
+        if (nl == std::string::npos) break;
+        std::string line = s.in.substr(pos, nl - pos);
+        pos = nl + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        command(s, line);
+    }
+    s.in.erase(0, pos);
+    if (s.in.size() > kMaxInput ||
+        (s.in.size() > kMaxLine && s.in.find('\n') == std::string::npos))
+        s.closing = true;
+    if (s.out.size() > kMaxPending) s.closing = true;
+}
+
+void Server::flush(Session& s) {
+    while (!s.out.empty() && s.fd >= 0) {
+        const ssize_t n = ::send(s.fd, s.out.data(), s.out.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            s.out.erase(0, static_cast<std::size_t>(n));
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                s.closing = true;
+                s.out.clear();
+            }
+            return;
+        }
+    }
+}
+
+void Server::settle(std::uint64_t id) {
+    auto it = sessions_.find(id);
+    if (it == sessions_.end()) return;
+    Session& s = *it->second;
+    if (s.closing) {
+        if (s.fd >= 0) {
+            ::close(s.fd);                // also leaves the epoll set
+            s.fd = -1;
+        }
+        if (!s.busy) sessions_.erase(it);   // else freed by onWake
+        return;
+    }
+    // No reading during a CPU turn or with a full buffer: the lines
+    // would only pile up, so the client waits on its socket instead.
+    const bool write = !s.out.empty();
+    const bool read = !s.busy && s.in.size() < kMaxInput;
+    if (write == s.writing && read == s.reading) return;
+    epoll_event ev{};
+    ev.events = (read ? EPOLLIN | EPOLLRDHUP : 0u) | (write ? EPOLLOUT : 0u);
+    ev.data.u64 = id;
+    ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, s.fd, &ev);
+    s.writing = write;
+    s.reading = read;
+}
+
+// ---------- Protocol ----------
+void Server::command(Session& s, const std::string& line) {
+    using std::to_string;
+    std::istringstream ss(line);
+    std::string cmd;
+    if (!(ss >> cmd)) return;
+    std::transform(cmd.begin(), cmd.end(), cmd.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    std::vector<long long> a;
+    if (!readInts(ss, a)) return emit(s, "ERR arguments are numbers");
+
+    if (cmd == "HELP") { emit(s, "OK"); s.out += kHelp; return; }
+    if (cmd == "QUIT") { emit(s, "OK"); flush(s); s.closing = true; return; }
+    if (cmd == "NEW") return newMatch(s, a);
+    if (cmd == "BOARD") {
+        if (!s.game) return emit(s, "ERR no match");
+        emit(s, "OK");
+        std::fill(s.owner.begin(), s.owner.end(), -1);
+        return sendChanges(s);
+    }
+
+    if (cmd != "PLACE" && cmd != "ATTACK" && cmd != "BLITZ" && cmd != "MOVE" &&
+        cmd != "FORTIFY" && cmd != "END")
+        return emit(s, "ERR unknown command (HELP)");
+    if (!s.game || s.game->pendingDecision().kind == Kind::None)
+        return emit(s, "ERR no match running (NEW)");
+
+    // The Game checks every action against the Rules; only the shape
+    // of the command and the decision it answers are checked here.
+    const Kind kind = s.game->pendingDecision().kind;
+    auto terr = [](long long v) { return v >= 0 && v < (1LL << 30) ? static_cast<TerrId>(v) : -1; };
+    auto count = [](long long v) { return static_cast<int>(std::clamp(v, -1LL, 1LL << 30)); };
+    Game::Action act;
+    if (cmd == "PLACE") {
+        if (kind != Kind::Reinforce) return emit(s, "ERR not now");
+        if (a.size() != 1) return emit(s, "ERR usage: PLACE <t>");
+        act = Game::Action::place(terr(a[0]));
+    } else if (cmd == "ATTACK" || cmd == "BLITZ") {
+        if (kind != Kind::Attack) return emit(s, "ERR not now");
+        if (a.size() != 2) return emit(s, "ERR usage: " + cmd + " <from> <to>");
+        act = Game::Action::attack(terr(a[0]), terr(a[1]), cmd == "BLITZ");
+    } else if (cmd == "MOVE") {
+        if (kind != Kind::Move) return emit(s, "ERR not now");
+        if (a.size() != 1) return emit(s, "ERR usage: MOVE <n>");
+        act = Game::Action::move(count(a[0]));
+    } else if (cmd == "FORTIFY") {
+        if (kind != Kind::Attack && kind != Kind::Fortify) return emit(s, "ERR not now");
+        if (a.size() != 3) return emit(s, "ERR usage: FORTIFY <from> <to> <n>");
+        act = Game::Action::fortify(terr(a[0]), terr(a[1]), count(a[2]));
+        // Checked before the attack phase is closed, so a refused move costs nothing.
+        const Board& b = s.game->board();
+        if (!Rules::canFortifyPath(b, act.from, act.to, PlayerId::P1) ||
+            act.amount < 1 || act.amount >= b.armies(act.from))
+            return emit(s, "ERR illegal fortify");
+    } else {   // END
+        if (kind != Kind::Attack && kind != Kind::Fortify) return emit(s, "ERR not now");
+        act = Game::Action::stop();
+    }
+
+    if (kind == Kind::Attack && act.pass) {
+        s.game->step(act, quiet_);                  // on to the fortify decision, if any
+        if (s.game->pendingDecision().kind == Kind::Fortify) s.game->step(act, quiet_);
+    } else {
+        if (kind == Kind::Attack && cmd == "FORTIFY") s.game->step(Game::Action::stop(), quiet_);
+        if (!s.game->step(act, quiet_)) {
+            if (kind == Kind::Reinforce) return emit(s, "ERR not your territory");
+            if (kind == Kind::Move)
+                return emit(s, "ERR usage: MOVE <1.." +
+                               to_string(s.game->pendingDecision().amount) + ">");
+            return emit(s, "ERR illegal attack");
+        }
+    }
+    emit(s, "OK");
+    if (cmd == "ATTACK" || cmd == "BLITZ") {
+        const Rules::BattleLosses& loss = s.game->lastBattle();
+        emit(s, "BATTLE " + to_string(act.from) + " " + to_string(act.to) + " " +
+                to_string(loss.attacker) + " " + to_string(loss.defender));
+    }
+    sendChanges(s);
+    prompt(s);
+}
+
+void Server::newMatch(Session& s, const std::vector<long long>& a) {
+    if (a.size() > 2) return emit(s, "ERR usage: NEW [seed] [territories]");
+    const std::uint32_t seed = a.empty() ? std::random_device{}()
+                                         : static_cast<std::uint32_t>(a[0]);
+    const long long n = a.size() > 1 ? a[1] : opt_.territories;
+    if (n < 2 || n > kMaxTerritories)
+        return emit(s, "ERR territories 2.." + std::to_string(kMaxTerritories));
+
+    s.game = std::make_unique<Game>(seed, static_cast<int>(n));
+    s.game->setupStartingPositions(seed);
+    s.cpu = makeCpu(opt_.ai, seed ^ 0x9E3779B9u);
+    ++matches_;
+
+    const Board& b = s.game->board();
+    emit(s, "OK");
+    emit(s, "MAP " + std::to_string(b.count()));
+    for (TerrId t = 0; t < b.count(); ++t) {
+        std::string line = "N " + std::to_string(t) + " " + b.name(t);
+        for (TerrId nb : b.neighbors(t)) line += " " + std::to_string(nb);
+        emit(s, line);
+    }
+    s.owner.assign(b.count(), -1);
+    s.armies.assign(b.count(), -1);
+    sendChanges(s);
+
+    s.game->start(quiet_);
+    sendChanges(s);                       // chain bonus
+    prompt(s);
+}
+
+void Server::prompt(Session& s) {
+    using std::to_string;
+    const Game::Decision& d = s.game->pendingDecision();
+    if (d.kind == Kind::None) return gameOver(s);
+    if (d.player == PlayerId::P2) return cpuTurn(s);
+    switch (d.kind) {
+        case Kind::Reinforce:
+            emit(s, "TURN " + to_string(s.game->turnsPlayed()) + " 1");
+            return emit(s, "REINFORCE " + to_string(d.amount));
+        case Kind::Attack:  return emit(s, "ATTACK");
+        case Kind::Fortify: return emit(s, "FORTIFY");
+        case Kind::Move:
+            return emit(s, "CAPTURED " + to_string(d.from) + " " + to_string(d.to) + " " +
+                           to_string(d.amount));
+        case Kind::None:    return;
+    }
+}
+
+void Server::cpuTurn(Session& s) {
+    emit(s, "TURN " + std::to_string(s.game->turnsPlayed()) + " 2");
+    s.busy = true;
+    Session* p = &s;
+    pool_.submit([this, p, id = s.id] {
+        NullView view;
+        p->game->playTurn(*p->cpu, view);
+        {
+            std::lock_guard<std::mutex> lk(doneM_);
+            done_.push_back(id);
+        }
+        const std::uint64_t one = 1;
+        if (::write(wakeFd_, &one, sizeof one) < 0) {}   // counter saturated: a wake is pending
+    });
+}
+
+void Server::gameOver(Session& s) {
+    const GameState st = s.game->finish(quiet_);
+    emit(s, st == GameState::Player1Wins ? "OVER 1" : st == GameState::Player2Wins ? "OVER 2" : "OVER 0");
+}
+
+void Server::sendChanges(Session& s) {
+    const Board& b = s.game->board();
+    for (TerrId t = 0; t < b.count(); ++t) {
+        const int owner = static_cast<int>(b.owner(t)) + 1, armies = b.armies(t);
+        if (owner == s.owner[t] && armies == s.armies[t]) continue;
+        s.owner[t] = owner;
+        s.armies[t] = armies;
+        emit(s, "T " + std::to_string(t) + " " + std::to_string(owner) + " " + std::to_string(armies));
+    }
+}
+
+void onSignal(int) { gStop = 1; }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 1;
+    if (!makeCpu(opt.ai, 1)) { std::cerr << "Unknown AI: " << opt.ai << "\n"; return 1; }
+
+    struct sigaction sa{};
+    sa.sa_handler = onSignal;             // no SA_RESTART: epoll_wait returns EINTR
+    ::sigaction(SIGINT, &sa, nullptr);
+    ::sigaction(SIGTERM, &sa, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    Server server(opt);
+    if (!server.open()) return 1;
+    std::cout << "server: listening on " << opt.path << " (" << opt.ai << ", "
+              << server.workers() << " workers)" << std::endl;
+    server.run();
+    return 0;
+}
@@ -0,0 +1,371 @@
+#include "BattleBatch.h"
+#include "Dice.h"
+#include "Instrument.h"
+#include <algorithm>
+#include <atomic>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MR_BATCH_X86 1
+#include <immintrin.h>
+#define MR_AVX2 __attribute__((target("avx2")))
+#define MR_AVX512 __attribute__((target("avx512f,avx512dq")))
+#else
+#define MR_BATCH_X86 0
+#endif
+
+namespace BattleBatch {
+
+namespace {
+
+constexpr std::uint64_t kMul1 = 0xBF58476D1CE4E5B9ull;    // Rng::mix64 constants
+constexpr std::uint64_t kMul2 = 0x94D049BB133111EBull;
+constexpr std::uint64_t kCtrOffset = 0x9E3779B97F4A7C15ull; // Rng::hash counter offset
+
+// Dice::kRound thresholds flattened to index (attDice-1)*2 + (defDice-1),
+// padded to one AVX-512 register.
+struct CutTable {
+    alignas(64) std::uint32_t c0[16];
+    alignas(64) std::uint32_t c1[16];
+};
+
+constexpr CutTable makeCutTable() {
+    CutTable t{};
+    for (int a = 0; a < 3; ++a)
+        for (int d = 0; d < 2; ++d) {
+            t.c0[a * 2 + d] = Dice::kRound.cut[a][d][0];
+            t.c1[a * 2 + d] = Dice::kRound.cut[a][d][1];
+        }
+    return t;
+}
+
+alignas(64) constexpr CutTable kCuts = makeCutTable();
+
+// ---------- Scalar ----------
+inline std::uint32_t draw(std::uint64_t key, std::uint64_t ctr) {
+    return static_cast<std::uint32_t>(Rng::hash(key, ctr) >> 32);
+}
+
+void roundsScalar(const std::uint8_t* att, const std::uint8_t* def, std::uint8_t* attLoss,
+                  std::uint8_t* defLoss, std::size_t n, std::uint64_t key, std::uint64_t ctr) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const int lost = Dice::attackerLosses(att[i], def[i], draw(key, ctr + i));
+        attLoss[i] = static_cast<std::uint8_t>(lost);
+        defLoss[i] = static_cast<std::uint8_t>(std::min(att[i], def[i]) - lost);
+    }
+}
+
+std::uint64_t battleScalar(std::int32_t& att, std::int32_t& def, std::uint64_t key) {
+    std::uint64_t r = 0;
+    while (def > 0 && att > 1) {
+        const int ad = std::min(3, att - 1), dd = std::min(2, def);
+        const int lost = Dice::attackerLosses(ad, dd, draw(key, r++));
+        att -= lost;
+        def -= std::min(ad, dd) - lost;
+    }
+    return r;
+}
+
+std::uint64_t battlesScalar(std::int32_t* att, std::int32_t* def, std::size_t n,
+                            const Rng::Stream& rng, std::uint64_t firstId) {
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        total += battleScalar(att[i], def[i], rng.split(firstId + i).key());
+    return total;
+}
+
+#if MR_BATCH_X86
+// ---------- AVX2: 8 lanes ----------
+// 64-bit lanes for the hash, 32-bit lanes for dice and armies.
+
+// a * c mod 2^64 from 32x32 products (AVX2 has no 64-bit multiply).
+MR_AVX2 inline __m256i mul64(__m256i a, std::uint64_t c) {
+    const __m256i lo = _mm256_set1_epi64x(static_cast<long long>(c & 0xFFFFFFFFull));
+    const __m256i hi = _mm256_set1_epi64x(static_cast<long long>(c >> 32));
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), lo),
+                                           _mm256_mul_epu32(a, hi));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, lo), _mm256_slli_epi64(cross, 32));
+}
+
+MR_AVX2 inline __m256i mix64(__m256i z) {
+    z = mul64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 30)), kMul1);
+    z = mul64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 27)), kMul2);
+    return _mm256_xor_si256(z, _mm256_srli_epi64(z, 31));
+}
+
+MR_AVX2 inline __m256i hash(__m256i key, __m256i ctr) {
+    const __m256i off = _mm256_set1_epi64x(static_cast<long long>(kCtrOffset));
+    return mix64(_mm256_xor_si256(key, mix64(_mm256_add_epi64(ctr, off))));
+}
+
+// High halves of two 4 x u64 vectors as one 8 x u32 vector, in order.
+MR_AVX2 inline __m256i high32(__m256i x, __m256i y) {
+    const __m256i pick = _mm256_setr_epi32(1, 3, 5, 7, 1, 3, 5, 7);
+    return _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(x, pick),
+                                     _mm256_permutevar8x32_epi32(y, pick), 0x20);
+}
+
+// Dice::attackerLosses per lane; k = compared pairs.
+MR_AVX2 inline __m256i losses(__m256i u, __m256i ad, __m256i dd, __m256i& k) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i idx = _mm256_add_epi32(_mm256_slli_epi32(_mm256_sub_epi32(ad, one), 1),
+                                         _mm256_sub_epi32(dd, one));
+    const __m256i c0 = _mm256_permutevar8x32_epi32(
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(kCuts.c0)), idx);
+    const __m256i c1 = _mm256_permutevar8x32_epi32(
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(kCuts.c1)), idx);
+    k = _mm256_min_epi32(ad, dd);
+    // u >= c (unsigned) as an all-ones mask
+    const __m256i ge0 = _mm256_cmpeq_epi32(_mm256_max_epu32(u, c0), u);
+    const __m256i ge1 = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(u, c1), u),
+                                         _mm256_cmpeq_epi32(k, _mm256_set1_epi32(2)));
+    return _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_add_epi32(ge0, ge1));
+}
+
+MR_AVX2 inline __m256i loadBytes(const std::uint8_t* p) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+MR_AVX2 inline void storeBytes(std::uint8_t* p, __m256i v) {
+    const __m256i low = _mm256_shuffle_epi8(v, _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+    const __m256i packed = _mm256_permutevar8x32_epi32(low, _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(packed));
+}
+
+MR_AVX2 void roundsAvx2(const std::uint8_t* att, const std::uint8_t* def, std::uint8_t* attLoss,
+                        std::uint8_t* defLoss, std::size_t n, std::uint64_t key, std::uint64_t ctr) {
+    const __m256i keys = _mm256_set1_epi64x(static_cast<long long>(key));
+    const __m256i step = _mm256_set1_epi64x(8);
+    __m256i ctr0 = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(ctr)),
+                                    _mm256_setr_epi64x(0, 1, 2, 3));
+    __m256i ctr1 = _mm256_add_epi64(ctr0, _mm256_set1_epi64x(4));
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i u = high32(hash(keys, ctr0), hash(keys, ctr1));
+        __m256i k;
+        const __m256i lost = losses(u, loadBytes(att + i), loadBytes(def + i), k);
+        storeBytes(attLoss + i, lost);
+        storeBytes(defLoss + i, _mm256_sub_epi32(k, lost));
+        ctr0 = _mm256_add_epi64(ctr0, step);
+        ctr1 = _mm256_add_epi64(ctr1, step);
+    }
+    roundsScalar(att + i, def + i, attLoss + i, defLoss + i, n - i, key, ctr + i);
+}
+
+// Lanes run until every battle in the group is over; finished lanes
+// are masked out and stop advancing their draw counters.
+MR_AVX2 std::uint64_t battlesAvx2(std::int32_t* att, std::int32_t* def, std::size_t n,
+                                  const Rng::Stream& rng, std::uint64_t firstId) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+    const __m256i three = _mm256_set1_epi32(3);
+    alignas(32) std::uint64_t keys[8];
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; ++j) keys[j] = rng.split(firstId + i + j).key();
+        const __m256i key0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys));
+        const __m256i key1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + 4));
+        __m256i ctr0 = zero, ctr1 = zero;
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(att + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(def + i));
+        for (;;) {
+            const __m256i live = _mm256_and_si256(_mm256_cmpgt_epi32(d, zero), _mm256_cmpgt_epi32(a, one));
+            const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(live));
+            if (!mask) break;
+            total += static_cast<std::uint64_t>(__builtin_popcount(mask));
+            // Clamped so finished lanes still index the table.
+            const __m256i ad = _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(a, one), one), three);
+            const __m256i dd = _mm256_min_epi32(_mm256_max_epi32(d, one), two);
+            __m256i k;
+            const __m256i lost = losses(high32(hash(key0, ctr0), hash(key1, ctr1)), ad, dd, k);
+            a = _mm256_sub_epi32(a, _mm256_and_si256(lost, live));
+            d = _mm256_sub_epi32(d, _mm256_and_si256(_mm256_sub_epi32(k, lost), live));
+            ctr0 = _mm256_sub_epi64(ctr0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(live)));
+            ctr1 = _mm256_sub_epi64(ctr1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(live, 1)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(att + i), a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(def + i), d);
+    }
+    return total + battlesScalar(att + i, def + i, n - i, rng, firstId + i);
+}
+
+// ---------- AVX-512: 16 lanes ----------
+// GCC 12's intrinsic headers trip -Wmaybe-uninitialized on their own
+// _mm512_undefined_* placeholders.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+MR_AVX512 inline __m512i mix64(__m512i z) {
+    z = _mm512_mullo_epi64(_mm512_xor_si512(z, _mm512_srli_epi64(z, 30)),
+                           _mm512_set1_epi64(static_cast<long long>(kMul1)));
+    z = _mm512_mullo_epi64(_mm512_xor_si512(z, _mm512_srli_epi64(z, 27)),
+                           _mm512_set1_epi64(static_cast<long long>(kMul2)));
+    return _mm512_xor_si512(z, _mm512_srli_epi64(z, 31));
+}
+
+MR_AVX512 inline __m512i hash(__m512i key, __m512i ctr) {
+    const __m512i off = _mm512_set1_epi64(static_cast<long long>(kCtrOffset));
+    return mix64(_mm512_xor_si512(key, mix64(_mm512_add_epi64(ctr, off))));
+}
+
+MR_AVX512 inline __m512i high32(__m512i x, __m512i y) {
+    const __m256i lo = _mm512_cvtepi64_epi32(_mm512_srli_epi64(x, 32));
+    const __m256i hi = _mm512_cvtepi64_epi32(_mm512_srli_epi64(y, 32));
+    return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+}
+
+MR_AVX512 inline __m512i losses(__m512i u, __m512i ad, __m512i dd, __m512i& k) {
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i idx = _mm512_add_epi32(_mm512_slli_epi32(_mm512_sub_epi32(ad, one), 1),
+                                         _mm512_sub_epi32(dd, one));
+    const __m512i c0 = _mm512_permutexvar_epi32(idx, _mm512_load_si512(kCuts.c0));
+    const __m512i c1 = _mm512_permutexvar_epi32(idx, _mm512_load_si512(kCuts.c1));
+    k = _mm512_min_epi32(ad, dd);
+    const __mmask16 ge0 = _mm512_cmpge_epu32_mask(u, c0);
+    const __mmask16 ge1 = _mm512_mask_cmpge_epu32_mask(
+        _mm512_cmpeq_epi32_mask(k, _mm512_set1_epi32(2)), u, c1);
+    return _mm512_add_epi32(_mm512_maskz_mov_epi32(ge0, one), _mm512_maskz_mov_epi32(ge1, one));
+}
+
+MR_AVX512 void roundsAvx512(const std::uint8_t* att, const std::uint8_t* def, std::uint8_t* attLoss,
+                            std::uint8_t* defLoss, std::size_t n, std::uint64_t key, std::uint64_t ctr) {
+    const __m512i keys = _mm512_set1_epi64(static_cast<long long>(key));
+    const __m512i step = _mm512_set1_epi64(16);
+    __m512i ctr0 = _mm512_add_epi64(_mm512_set1_epi64(static_cast<long long>(ctr)),
+                                    _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+    __m512i ctr1 = _mm512_add_epi64(ctr0, _mm512_set1_epi64(8));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i u = high32(hash(keys, ctr0), hash(keys, ctr1));
+        const __m512i ad = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(att + i)));
+        const __m512i dd = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(def + i)));
+        __m512i k;
+        const __m512i lost = losses(u, ad, dd, k);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(attLoss + i), _mm512_cvtepi32_epi8(lost));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(defLoss + i),
+                         _mm512_cvtepi32_epi8(_mm512_sub_epi32(k, lost)));
+        ctr0 = _mm512_add_epi64(ctr0, step);
+        ctr1 = _mm512_add_epi64(ctr1, step);
+    }
+    roundsScalar(att + i, def + i, attLoss + i, defLoss + i, n - i, key, ctr + i);
+}
+
+MR_AVX512 std::uint64_t battlesAvx512(std::int32_t* att, std::int32_t* def, std::size_t n,
+                                      const Rng::Stream& rng, std::uint64_t firstId) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i two = _mm512_set1_epi32(2);
+    const __m512i three = _mm512_set1_epi32(3);
+    const __m512i one64 = _mm512_set1_epi64(1);
+    alignas(64) std::uint64_t keys[16];
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        for (int j = 0; j < 16; ++j) keys[j] = rng.split(firstId + i + j).key();
+        const __m512i key0 = _mm512_load_si512(keys);
+        const __m512i key1 = _mm512_load_si512(keys + 8);
+        __m512i ctr0 = zero, ctr1 = zero;
+        __m512i a = _mm512_loadu_si512(att + i);
+        __m512i d = _mm512_loadu_si512(def + i);
+        for (;;) {
+            const __mmask16 live = _mm512_cmpgt_epi32_mask(d, zero) & _mm512_cmpgt_epi32_mask(a, one);
+            if (!live) break;
+            total += static_cast<std::uint64_t>(__builtin_popcount(live));
+            const __m512i ad = _mm512_min_epi32(_mm512_max_epi32(_mm512_sub_epi32(a, one), one), three);
+            const __m512i dd = _mm512_min_epi32(_mm512_max_epi32(d, one), two);
+            __m512i k;
+            const __m512i lost = losses(high32(hash(key0, ctr0), hash(key1, ctr1)), ad, dd, k);
+            a = _mm512_mask_sub_epi32(a, live, a, lost);
+            d = _mm512_mask_sub_epi32(d, live, d, _mm512_sub_epi32(k, lost));
+            ctr0 = _mm512_mask_add_epi64(ctr0, static_cast<__mmask8>(live), ctr0, one64);
+            ctr1 = _mm512_mask_add_epi64(ctr1, static_cast<__mmask8>(live >> 8), ctr1, one64);
+        }
+        _mm512_storeu_si512(att + i, a);
+        _mm512_storeu_si512(def + i, d);
+    }
+    return total + battlesScalar(att + i, def + i, n - i, rng, firstId + i);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif // MR_BATCH_X86
+
+// ---------- Dispatch ----------
+Isa best() {
+    if (supported(Isa::Avx512)) return Isa::Avx512;
+    if (supported(Isa::Avx2)) return Isa::Avx2;
+    return Isa::Scalar;
+}
+
+std::atomic<Isa>& current() {
+    static std::atomic<Isa> isa{best()};
+    return isa;
+}
+
+} // namespace
+
+const char* name(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::Avx2:   return "avx2";
+        case Isa::Avx512: return "avx512";
+    }
+    return "?";
+}
+
+bool supported(Isa isa) {
+#if MR_BATCH_X86
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::Scalar: return true;
+        case Isa::Avx2:   return __builtin_cpu_supports("avx2");
+        case Isa::Avx512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+    }
+    return false;
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+Isa active() { return current().load(std::memory_order_relaxed); }
+
+bool setIsa(Isa isa) {
+    if (!supported(isa)) return false;
+    current().store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+void rounds(const std::uint8_t* attDice, const std::uint8_t* defDice,
+            std::uint8_t* attLoss, std::uint8_t* defLoss,
+            std::size_t n, Rng::Stream& rng) {
+    MR_COUNT_N(kDiceRounds, n);
+    const std::uint64_t key = rng.key(), ctr = rng.counter();
+    rng.discard(n);
+    switch (active()) {
+#if MR_BATCH_X86
+        case Isa::Avx512: return roundsAvx512(attDice, defDice, attLoss, defLoss, n, key, ctr);
+        case Isa::Avx2:   return roundsAvx2(attDice, defDice, attLoss, defLoss, n, key, ctr);
+#endif
+        default:          return roundsScalar(attDice, defDice, attLoss, defLoss, n, key, ctr);
+    }
+}
+
+std::uint64_t battles(std::int32_t* attackers, std::int32_t* defenders,
+                      std::size_t n, const Rng::Stream& rng, std::uint64_t firstId) {
+    std::uint64_t fought = 0;
+    switch (active()) {
+#if MR_BATCH_X86
+        case Isa::Avx512: fought = battlesAvx512(attackers, defenders, n, rng, firstId); break;
+        case Isa::Avx2:   fought = battlesAvx2(attackers, defenders, n, rng, firstId); break;
+#endif
+        default:          fought = battlesScalar(attackers, defenders, n, rng, firstId); break;
+    }
+    MR_COUNT_N(kDiceRounds, fought);
+    return fought;
+}
+
+} // namespace BattleBatch
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Rng.h"
+
+// ------------------------------------------------------------
+// BattleBatch — many independent battles per call
+// ------------------------------------------------------------
+// Bulk Monte Carlo form of Rules::simulateBattleOnce and
+// Rules::applyBattle. Inputs and outputs are caller-owned
+// struct-of-arrays buffers. Random draws, the Dice threshold
+// comparison and the loss updates run 8 (AVX2) or 16 (AVX-512)
+// battles per vector. The kernel is picked at run time from what
+// the CPU supports, with a scalar fallback. Every draw is
+// Rng::hash of a (key, counter) pair, so all kernels give
+// bit-identical results to each other and to the one-at-a-time
+// Rules calls.
+//
+namespace BattleBatch {
+
+    enum class Isa { Scalar, Avx2, Avx512 };
+
+    const char* name(Isa isa);
+    bool supported(Isa isa);
+    Isa active();                    // best supported unless overridden
+    bool setIsa(Isa isa);            // false (and unchanged) if unsupported
+
+    // n single dice rounds: round i rolls attDice[i] (1..3) against
+    // defDice[i] (1..2) with draw i of `rng`, exactly as n calls to
+    // Rules::simulateBattleOnce(attDice[i], defDice[i], rng) would.
+    // rng advances by n.
+    void rounds(const std::uint8_t* attDice, const std::uint8_t* defDice,
+                std::uint8_t* attLoss, std::uint8_t* defLoss,
+                std::size_t n, Rng::Stream& rng);
+
+    // n whole battles, each fought until capture or until one attacker
+    // is left (Rules::applyBattle repeated). attackers[i] / defenders[i]
+    // are the armies on `from` / `to` on input and what is left on
+    // output; defenders[i] == 0 means captured. Battle i rolls from
+    // rng.split(firstId + i), so a large batch can be cut into chunks
+    // (or spread over threads) without changing any result.
+    // Returns the number of dice rounds fought.
+    std::uint64_t battles(std::int32_t* attackers, std::int32_t* defenders,
+                          std::size_t n, const Rng::Stream& rng,
+                          std::uint64_t firstId = 0);
+
+} // namespace BattleBatch
@@ -0,0 +1,133 @@
+#include "BattleOdds.h"
+#include "Dice.h"
+#include "Rules.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Same dice rules as Rules::attackerDice / defenderDice, usable at compile time.
+constexpr int attDiceFor(int armies) { return armies > 1 ? (armies - 1 < 3 ? armies - 1 : 3) : 0; }
+constexpr int defDiceFor(int armies) { return armies > 0 ? (armies < 2 ? armies : 2) : 0; }
+
+// ---------- Capture table for small armies (constexpr) ----------
+constexpr int kN = BattleOdds::kTableMax + 1;
+struct CaptureTable { double p[kN][kN]; };
+
+constexpr CaptureTable makeCaptureTable() {
+    CaptureTable t{};
+    for (int a = 0; a < kN; ++a)
+        for (int d = 0; d < kN; ++d) {
+            if (d == 0) { t.p[a][d] = (a > 0) ? 1.0 : 0.0; continue; }
+            if (a <= 1) { t.p[a][d] = 0.0; continue; }
+            int ad = attDiceFor(a), dd = defDiceFor(d);
+            int k = ad < dd ? ad : dd;
+            double sum = 0.0;
+            for (int i = 0; i <= k; ++i)
+                sum += Dice::lossProb(ad, dd, i) * t.p[a - i][d - (k - i)];
+            t.p[a][d] = sum;
+        }
+    return t;
+}
+
+constexpr CaptureTable kCapture = makeCaptureTable();
+
+// ---------- Lazily grown memo for larger armies ----------
+// Beyond kMemoMax per side both counts are scaled down together; the
+// result is then an approximation (the chain is near-deterministic there).
+constexpr int kMemoMax = 1024;
+
+struct CaptureMemo {
+    int dim{0};                  // table covers [0, dim) x [0, dim)
+    std::vector<double> p;
+
+    double get(int a, int d) {
+        int need = std::max(a, d) + 1;
+        if (need > dim) grow(need);
+        return p[static_cast<size_t>(a) * dim + d];
+    }
+
+    void grow(int need) {
+        int nd = std::max(need, std::min(kMemoMax + 1, std::max(2 * dim, 2 * kN)));
+        std::vector<double> np(static_cast<size_t>(nd) * nd);
+        for (int a = 0; a < nd; ++a)
+            for (int d = 0; d < nd; ++d) {
+                double& out = np[static_cast<size_t>(a) * nd + d];
+                if (a < dim && d < dim) { out = p[static_cast<size_t>(a) * dim + d]; continue; }
+                if (d == 0) { out = (a > 0) ? 1.0 : 0.0; continue; }
+                if (a <= 1) { out = 0.0; continue; }
+                int ad = attDiceFor(a), dd = defDiceFor(d);
+                int k = std::min(ad, dd);
+                double sum = 0.0;
+                for (int i = 0; i <= k; ++i)
+                    sum += Dice::lossProb(ad, dd, i) * np[static_cast<size_t>(a - i) * nd + (d - (k - i))];
+                out = sum;
+            }
+        p.swap(np);
+        dim = nd;
+    }
+};
+
+thread_local CaptureMemo tlsMemo;
+
+} // namespace
+
+// ------------------------------------------------------------
+namespace BattleOdds {
+
+double roundLossProb(int attDice, int defDice, int attLoss) {
+    if (attDice < 1 || attDice > 3 || defDice < 1 || defDice > 2) return 0.0;
+    if (attLoss < 0 || attLoss > std::min(attDice, defDice)) return 0.0;
+    return Dice::lossProb(attDice, defDice, attLoss);
+}
+
+double captureProb(int attackers, int defenders) {
+    if (defenders <= 0) return attackers > 0 ? 1.0 : 0.0;
+    if (attackers <= 1) return 0.0;
+    if (attackers < kN && defenders < kN) return kCapture.p[attackers][defenders];
+
+    int m = std::max(attackers, defenders);
+    if (m > kMemoMax) {
+        double s = static_cast<double>(kMemoMax) / m;
+        attackers = std::max(2, static_cast<int>(std::lround(attackers * s)));
+        defenders = std::max(1, static_cast<int>(std::lround(defenders * s)));
+    }
+    return tlsMemo.get(attackers, defenders);
+}
+
+double Outcome::captureProb() const {
+    double s = 0.0;
+    for (double x : attackerLeft) s += x;
+    return s;
+}
+
+Outcome distribution(int attackers, int defenders) {
+    Outcome out;
+    const int A = std::max(0, attackers), D = std::max(0, defenders);
+    out.attackerLeft.assign(A + 1, 0.0);
+    out.defenderLeft.assign(D + 1, 0.0);
+    if (D == 0) { if (A > 0) out.attackerLeft[A] = 1.0; return out; }
+    if (A <= 1) { out.defenderLeft[D] = 1.0; return out; }
+
+    // Forward DP: probability mass of reaching each (a, d); every round
+    // removes at least one army, so sweeping a + d downwards is topological.
+    std::vector<double> mass(static_cast<size_t>(A + 1) * (D + 1), 0.0);
+    auto at = [&](int a, int d) -> double& { return mass[static_cast<size_t>(a) * (D + 1) + d]; };
+    at(A, D) = 1.0;
+
+    for (int s = A + D; s >= 0; --s)
+        for (int a = std::min(A, s); a >= 0 && s - a <= D; --a) {
+            int d = s - a;
+            double m = at(a, d);
+            if (m == 0.0) continue;
+            if (d == 0) { out.attackerLeft[a] += m; continue; }
+            if (a <= 1) { out.defenderLeft[d] += m; continue; }
+            int ad = Rules::attackerDice(a), dd = Rules::defenderDice(d);
+            int k = std::min(ad, dd);
+            for (int i = 0; i <= k; ++i)
+                at(a - i, d - (k - i)) += m * Dice::lossProb(ad, dd, i);
+        }
+    return out;
+}
+
+} // namespace BattleOdds
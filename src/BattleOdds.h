@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+
+// ------------------------------------------------------------
+// BattleOdds — exact battle outcome probabilities
+// ------------------------------------------------------------
+// A battle is the Markov chain Rules::applyBattle walks one dice
+// round at a time: state (attackers, defenders), dice from
+// Rules::attackerDice / Rules::defenderDice, ending when the
+// defender reaches 0 (capture) or the attacker is down to 1.
+//
+// Capture odds come from a constexpr table for small armies and
+// from a lazily grown per-thread memo for larger ones, so a query
+// is a lookup instead of a Monte Carlo loop.
+//
+namespace BattleOdds {
+
+    // Armies per side covered by the compile-time table.
+    constexpr int kTableMax = 24;
+
+    // Probability that one round with (attDice, defDice) costs the
+    // attacker exactly attLoss armies; the defender loses the rest of
+    // the min(attDice, defDice) compared pairs.
+    double roundLossProb(int attDice, int defDice, int attLoss);
+
+    // Probability that attacking from a territory with `attackers`
+    // armies (one must stay behind) eventually takes a territory
+    // held by `defenders` armies.
+    double captureProb(int attackers, int defenders);
+
+    // Full end-of-battle distribution.
+    struct Outcome {
+        std::vector<double> attackerLeft;  // [k]: captured, k armies left on `from`
+        std::vector<double> defenderLeft;  // [k]: stalled at 1 attacker, k defenders left
+        double captureProb() const;
+    };
+    Outcome distribution(int attackers, int defenders);
+
+} // namespace BattleOdds
@@ -0,0 +1,125 @@
+#include "Blitz.h"
+#include "BattleOdds.h"
+#include "Dice.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// ---------- Alias table (Vose) ----------
+class AliasTable {
+public:
+    void build(const std::vector<double>& weights) {
+        const std::size_t n = weights.size();
+        prob_.assign(n, 1.0);
+        alias_.assign(n, 0);
+        double sum = 0.0;
+        for (double w : weights) sum += w;
+
+        std::vector<double> scaled(n);
+        std::vector<std::uint32_t> small, large;
+        for (std::size_t i = 0; i < n; ++i) {
+            scaled[i] = weights[i] * static_cast<double>(n) / sum;
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+        }
+        while (!small.empty() && !large.empty()) {
+            const std::uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            prob_[s] = scaled[s];
+            alias_[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) { large.pop_back(); small.push_back(l); }
+        }
+        // Leftovers are 1 up to rounding.
+    }
+
+    int sample(Rng::Stream& rng) const {
+        const std::uint32_t i = rng.below(static_cast<std::uint32_t>(prob_.size()));
+        const double u = static_cast<double>(rng() >> 11) * 0x1.0p-53;
+        return static_cast<int>(u < prob_[i] ? i : alias_[i]);
+    }
+
+private:
+    std::vector<double> prob_;
+    std::vector<std::uint32_t> alias_;
+};
+
+struct Tables {
+    // small[a][d]: outcome i <= a is "captured, i attackers left";
+    // outcome a + 1 + j is "stalled, j defenders left".
+    AliasTable small[Blitz::kTableMax + 1][Blitz::kTableMax + 1];
+    // rounds[j]: defender losses over 2^j rounds of 3 dice vs 2.
+    AliasTable rounds[Blitz::kMaxLevel + 1];
+
+    Tables() {
+        for (int a = 2; a <= Blitz::kTableMax; ++a)
+            for (int d = 1; d <= Blitz::kTableMax; ++d) {
+                const BattleOdds::Outcome o = BattleOdds::distribution(a, d);
+                std::vector<double> w(o.attackerLeft);
+                w.insert(w.end(), o.defenderLeft.begin(), o.defenderLeft.end());
+                small[a][d].build(w);
+            }
+
+        // Level 0 is one round; level j convolves level j-1 with itself.
+        std::vector<double> level(3);
+        for (int defLoss = 0; defLoss <= 2; ++defLoss)
+            level[defLoss] = Dice::lossProb(3, 2, 2 - defLoss);
+        rounds[0].build(level);
+        for (int j = 1; j <= Blitz::kMaxLevel; ++j) {
+            std::vector<double> next(2 * level.size() - 1, 0.0);
+            for (std::size_t x = 0; x < level.size(); ++x)
+                for (std::size_t y = 0; y < level.size(); ++y)
+                    next[x + y] += level[x] * level[y];
+            level.swap(next);
+            rounds[j].build(level);
+        }
+    }
+};
+
+const Tables& tables() {
+    static const Tables t;
+    return t;
+}
+
+// Defender losses over k rounds of 3 dice vs 2.
+long long sampleRounds(long long k, const Tables& t, Rng::Stream& rng) {
+    long long lost = 0;
+    for (long long full = k >> Blitz::kMaxLevel; full > 0; --full)
+        lost += t.rounds[Blitz::kMaxLevel].sample(rng);
+    for (int j = Blitz::kMaxLevel - 1; j >= 0; --j)
+        if ((k >> j) & 1) lost += t.rounds[j].sample(rng);
+    return lost;
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+namespace Blitz {
+
+Result resolve(int attackers, int defenders, Rng::Stream& rng) {
+    int a = std::max(0, attackers), d = std::max(0, defenders);
+    const Tables& t = tables();
+
+    while (d > 0 && a > 1) {
+        if (a <= kTableMax && d <= kTableMax) {
+            const int i = t.small[a][d].sample(rng);
+            return i <= a ? Result{i, 0} : Result{1, i - a - 1};
+        }
+        if (a >= 4 && d >= 2) {
+            // No round in the chunk can leave the 3-vs-2 dice regime.
+            const long long k = std::min((a - 4) / 2, (d - 2) / 2) + 1;
+            const long long defLoss = sampleRounds(k, t, rng);
+            d -= static_cast<int>(defLoss);
+            a -= static_cast<int>(2 * k - defLoss);
+            continue;
+        }
+        // One side is down to its last dice: a few single rounds.
+        const int ad = std::min(3, a - 1), dd = std::min(2, d);
+        const int lost = Dice::attackerLosses(ad, dd, rng.next32());
+        a -= lost;
+        d -= std::min(ad, dd) - lost;
+    }
+    return {a, d};
+}
+
+} // namespace Blitz
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include "Rng.h"
+
+// ------------------------------------------------------------
+// Blitz — a whole battle resolved in one step
+// ------------------------------------------------------------
+// Samples where Rules::applyBattle, repeated until capture or
+// until one attacker is left, would end, without rolling every
+// round:
+//  • Both sides ≤ kTableMax: one draw from an alias table over
+//    the exact end-of-battle distribution (BattleOdds)
+//  • Larger: while the attacker rolls 3 dice and the defender 2,
+//    every round removes exactly 2 armies, so k rounds are a sum
+//    of k i.i.d. defender losses. k is split into powers of two
+//    and each part is one alias draw from the exact distribution
+//    of that many rounds (tables up to 2^kMaxLevel rounds, built
+//    once by convolution). Small tails use the tables above or
+//    single Dice rounds.
+// No step approximates the battle; table entries only carry double
+// rounding (< 1e-12 total variation per battle). Cost grows with
+// log(armies), plus one draw per 2^kMaxLevel rounds beyond that.
+//
+namespace Blitz {
+
+    constexpr int kTableMax = 16;    // per side, exact outcome tables
+    constexpr int kMaxLevel = 10;    // largest multi-round table: 2^10 rounds
+
+    struct Result {
+        int attackers;               // left on `from`
+        int defenders;               // left on `to` (0 = captured)
+    };
+
+    // `attackers` / `defenders` as in BattleOdds::captureProb.
+    Result resolve(int attackers, int defenders, Rng::Stream& rng);
+
+} // namespace Blitz
@@ -1,33 +1,279 @@
 #include "Board.h"
+#include "Renderer.h"
+#include "Zobrist.h"
 #include <algorithm>
 #include <sstream>
-#include <unordered_set>
 
 // ---------- Construction ----------
-Board::Board(std::vector<Territory> territories)
-    : territories_(std::move(territories)) {}
+Board::Board(const std::vector<Territory>& territories)
+    : Board(MapTopology::make(territories)) {}
+
+Board::Board(std::shared_ptr<const MapTopology> topology)
+    : topo_(std::move(topology)),
+      owner_(topo_->count(), static_cast<std::int8_t>(PlayerId::None)),
+      armies_(topo_->count(), 0) {
+    rebuildTracking();
+}
+
+void Board::rebuildTracking() {
+    const int n = count();
+    const bool masks = hasMasks();
+    for (int k = 0; k < 2; ++k) {
+        owned_[k] = armyTotal_[k] = 0;
+        frontier_[k].clear();
+        ownerMask_[k] = frontierMask_[k] = TerrMask{};
+    }
+    ownerHash_ = armyHash_ = 0;
+    foreign_.assign(n, 0);
+    frontierPos_.assign(n, 0);
+    frontierSide_.assign(n, -1);
+
+    for (int i = 0; i < n; ++i) {
+        const PlayerId o = owner(i);
+        for (TerrId j : neighbors(i))
+            if (owner(j) != o) ++foreign_[i];
+        ownerHash_ ^= Zobrist::owner(i, o);
+        armyHash_ ^= Zobrist::armies(i, armies_[i]);
+        if (o == PlayerId::None) continue;
+        int k = static_cast<int>(o);
+        ++owned_[k];
+        armyTotal_[k] += armies_[i];
+        if (masks) ownerMask_[k].set(i);
+    }
+    for (int i = 0; i < n; ++i) refreshFrontier(i);
+    comps_.build(*this);
+}
+
+// ---------- Snapshots ----------
+void Board::save(Snapshot& out) const {
+    out.owner = owner_;
+    out.armies = armies_;
+}
+
+void Board::restore(const Snapshot& s) {
+    owner_ = s.owner;
+    armies_ = s.armies;
+    rebuildTracking();
+}
 
 // ---------- Accessors ----------
-const std::vector<Territory>& Board::getTerritories() const { return territories_; }
-std::vector<Territory>& Board::getTerritories() { return territories_; }
-int Board::count() const { return static_cast<int>(territories_.size()); }
-const Territory& Board::at(TerrId id) const { return territories_.at(id); }
-Territory& Board::at(TerrId id) { return territories_.at(id); }
+GameState Board::status() const {
+    if (owned_[0] && !owned_[1]) return GameState::Player1Wins;
+    if (owned_[1] && !owned_[0]) return GameState::Player2Wins;
+    return GameState::Ongoing;
+}
+
+std::uint64_t Board::hash(PlayerId toMove) const {
+    return ownerHash_ ^ armyHash_ ^ Zobrist::side(toMove);
+}
+
+std::uint64_t Board::ownershipHash(PlayerId toMove) const {
+    return ownerHash_ ^ Zobrist::side(toMove);
+}
+
+// ---------- Mutation ----------
+void Board::place(TerrId id, PlayerId p, int armies) {
+    record({UndoEntry::Place, owner_.at(id), id, -1, armies_[id], 0});
+    setArmies(id, 0);
+    setOwner(id, p);
+    setArmies(id, armies);
+}
+
+void Board::addArmies(TerrId id, int n) {
+    record({UndoEntry::Armies, 0, id, -1, n, 0});
+    setArmies(id, armies_.at(id) + n);
+}
+
+bool Board::applyLosses(TerrId from, TerrId to, int attackerLoss, int defenderLoss) {
+    int dl = std::min(defenderLoss, armies_.at(to));
+    record({UndoEntry::Losses, 0, from, to, attackerLoss, dl});
+
+    setArmies(from, armies_.at(from) - attackerLoss);
+    setArmies(to, armies_[to] - dl);
+    return armies_[to] <= 0;
+}
+
+void Board::capture(TerrId id, PlayerId newOwner) {
+    record({UndoEntry::Owner, owner_.at(id), id, -1, 0, 0});
+    addArmyTotal(owner(id), -armies_[id]);
+    setOwner(id, newOwner);
+    addArmyTotal(newOwner, armies_[id]);
+}
+
+void Board::moveArmies(TerrId from, TerrId to, int n) {
+    record({UndoEntry::Move, 0, from, to, n, 0});
+    setArmies(from, armies_.at(from) - n);
+    setArmies(to, armies_.at(to) + n);
+}
+
+// ---------- Make / unmake ----------
+void Board::beginRecording() {
+    undo_.clear();
+    undo_.reserve(kMaxUndo);
+    sealed_ = 0;
+    undoLost_ = false;
+    recording_ = true;
+}
+
+void Board::endRecording() {
+    recording_ = false;
+    undo_.clear();
+    sealed_ = 0;
+}
+
+void Board::record(const UndoEntry& e) {
+    if (!recording_) return;
+    if (static_cast<int>(undo_.size()) > sealed_) {
+        // A battle fought round by round, or repeated reinforcement of one
+        // territory, collapses into a single entry.
+        UndoEntry& top = undo_.back();
+        if (top.kind == e.kind && top.a == e.a && top.b == e.b &&
+            (e.kind == UndoEntry::Losses || e.kind == UndoEntry::Armies)) {
+            top.n += e.n;
+            top.m += e.m;
+            return;
+        }
+    }
+    if (static_cast<int>(undo_.size()) >= kMaxUndo) { undoLost_ = true; return; }
+    undo_.push_back(e);
+}
+
+bool Board::undoTo(int mark) {
+    const bool wasRecording = recording_;
+    recording_ = false;
+    while (static_cast<int>(undo_.size()) > mark) {
+        const UndoEntry e = undo_.back();
+        undo_.pop_back();
+        switch (e.kind) {
+            case UndoEntry::Armies:
+                addArmies(e.a, -e.n);
+                break;
+            case UndoEntry::Losses:
+                setArmies(e.a, armies_[e.a] + e.n);
+                setArmies(e.b, armies_[e.b] + e.m);
+                break;
+            case UndoEntry::Owner:
+                capture(e.a, static_cast<PlayerId>(e.prevOwner));
+                break;
+            case UndoEntry::Move:
+                moveArmies(e.b, e.a, e.n);
+                break;
+            case UndoEntry::Place:
+                place(e.a, static_cast<PlayerId>(e.prevOwner), e.n);
+                break;
+        }
+    }
+    recording_ = wasRecording;
+    sealed_ = static_cast<int>(undo_.size());
+    bool ok = !undoLost_;
+    if (mark == 0) undoLost_ = false;
+    return ok;
+}
+
+// ---------- Tracking helpers ----------
+void Board::addArmyTotal(PlayerId p, int n) {
+    if (p != PlayerId::None) armyTotal_[static_cast<int>(p)] += n;
+}
+
+void Board::setArmies(TerrId id, int n) {
+    armyHash_ ^= Zobrist::armies(id, armies_[id]) ^ Zobrist::armies(id, n);
+    addArmyTotal(owner(id), n - armies_[id]);
+    armies_[id] = n;
+}
+
+void Board::setOwner(TerrId id, PlayerId p) {
+    const PlayerId old = owner(id);
+    if (old == p) return;
 
-// ---------- Adjacency Helpers ----------
-const std::vector<TerrId>& Board::neighbors(TerrId id) const { return territories_.at(id).adj; }
+    const bool masks = hasMasks();
+    if (old != PlayerId::None) {
+        --owned_[static_cast<int>(old)];
+        if (masks) ownerMask_[static_cast<int>(old)].reset(id);
+    }
+    if (p != PlayerId::None) {
+        ++owned_[static_cast<int>(p)];
+        if (masks) ownerMask_[static_cast<int>(p)].set(id);
+    }
+    owner_[id] = static_cast<std::int8_t>(p);
+    ownerHash_ ^= Zobrist::owner(id, old) ^ Zobrist::owner(id, p);
 
-bool Board::areAdjacent(TerrId a, TerrId b) const {
-    const auto& nb = neighbors(a);
-    return std::find(nb.begin(), nb.end(), b) != nb.end();
+    // Only this territory and its neighbours can change frontier status.
+    int f = 0;
+    for (TerrId n : neighbors(id)) {
+        const PlayerId o = owner(n);
+        if (o != p) ++f;
+        foreign_[n] += static_cast<int>(o != p) - static_cast<int>(o != old);
+        refreshFrontier(n);
+    }
+    foreign_[id] = f;
+    refreshFrontier(id);
+    comps_.onOwnerChange(*this, id, old, p);
+}
+
+void Board::refreshFrontier(TerrId id) {
+    const PlayerId o = owner(id);
+    const int want = (o != PlayerId::None && foreign_[id] > 0) ? static_cast<int>(o) : -1;
+    const int have = frontierSide_[id];
+    if (want == have) return;
+
+    const bool masks = hasMasks();
+    if (have >= 0) {
+        auto& list = frontier_[have];
+        TerrId last = list.back();
+        list[frontierPos_[id]] = last;
+        frontierPos_[last] = frontierPos_[id];
+        list.pop_back();
+        if (masks) frontierMask_[have].reset(id);
+    }
+    if (want >= 0) {
+        frontierPos_[id] = static_cast<int>(frontier_[want].size());
+        frontier_[want].push_back(id);
+        if (masks) frontierMask_[want].set(id);
+    }
+    frontierSide_[id] = static_cast<signed char>(want);
+}
+
+// ---------- Validators (tracking) ----------
+bool Board::validateTracking() const {
+    Board fresh(topo_);
+    fresh.owner_ = owner_;
+    fresh.armies_ = armies_;
+    fresh.rebuildTracking();
+    const bool masks = hasMasks();
+    for (int k = 0; k < 2; ++k) {
+        if (fresh.owned_[k] != owned_[k] || fresh.armyTotal_[k] != armyTotal_[k]) return false;
+        if (fresh.frontier_[k].size() != frontier_[k].size()) return false;
+        if (masks && (fresh.ownerMask_[k] != ownerMask_[k] ||
+                          fresh.frontierMask_[k] != frontierMask_[k])) return false;
+        for (TerrId id : frontier_[k])
+            if (fresh.frontierSide_[id] != k || frontierSide_[id] != k)
+                return false;
+    }
+    if (fresh.foreign_ != foreign_) return false;
+    if (fresh.ownerHash_ != ownerHash_ || fresh.armyHash_ != armyHash_) return false;
+
+    int s1 = 0, s2 = 0;
+    TerrId m1 = -1, m2 = -1;
+    for (PlayerId p : {PlayerId::P1, PlayerId::P2}) {
+        if (fresh.comps_.largest(p, s1, m1) != comps_.largest(p, s2, m2)) return false;
+        if (s1 != s2 || m1 != m2) return false;
+        if (fresh.comps_.componentCount(p) != comps_.componentCount(p)) return false;
+    }
+    for (int i = 0; i < count(); ++i) {
+        if (fresh.comps_.componentSize(i) != comps_.componentSize(i)) return false;
+        for (TerrId j : neighbors(i))
+            if (fresh.comps_.connected(i, j) != comps_.connected(i, j)) return false;
+    }
+    return true;
 }
 
 // ---------- ASCII Rendering ----------
 std::string Board::render(bool showOwner, bool showArmies, int cellWidth) const {
+    const MapTopology& topo = *topo_;
     int maxR = 0, maxC = 0;
-    for (const auto& x : territories_) {
-        maxR = std::max(maxR, x.r);
-        maxC = std::max(maxC, x.c);
+    for (int i = 0; i < count(); ++i) {
+        maxR = std::max(maxR, topo.row(i));
+        maxC = std::max(maxC, topo.col(i));
     }
 
     const int rows = maxR + 1;
@@ -42,32 +288,33 @@ std::string Board::render(bool showOwner, bool showArmies, int cellWidth) const
         }
     };
 
-    for (const auto& x : territories_) {
-        if (x.r < 0 || x.c < 0 || x.r >= rows || x.c >= cols) continue;
-        const int colOffset = x.c * cellWidth;
+    for (int i = 0; i < count(); ++i) {
+        const int r = topo.row(i), c = topo.col(i);
+        if (r < 0 || c < 0 || r >= rows || c >= cols) continue;
+        const int colOffset = c * cellWidth;
 
         std::string cell(cellWidth, ' ');
-        cell[0] = x.code;
+        cell[0] = topo.code(i);
         int writePos = 1;
 
         if (showOwner && writePos < cellWidth)
-            cell[writePos++] = ownerChar(x.owner);
+            cell[writePos++] = ownerChar(owner(i));
 
         if (showArmies && writePos < cellWidth) {
-            std::string a = std::to_string(std::max(0, x.armies));
+            std::string a = std::to_string(std::max(0, armies_[i]));
             int remain = cellWidth - writePos;
             if ((int)a.size() <= remain) {
                 int start = writePos + (remain - static_cast<int>(a.size()));
-                for (size_t i = 0; i < a.size() && (start + (int)i) < cellWidth; ++i)
-                    cell[start + (int)i] = a[i];
+                for (size_t d = 0; d < a.size() && (start + (int)d) < cellWidth; ++d)
+                    cell[start + (int)d] = a[d];
             } else {
-                for (int i = 0; i < remain; ++i)
-                    cell[writePos + i] = a[(int)a.size() - remain + i];
+                for (int d = 0; d < remain; ++d)
+                    cell[writePos + d] = a[(int)a.size() - remain + d];
             }
         }
 
-        for (int k = 0; k < cellWidth && (colOffset + k) < (int)canvas[x.r].size(); ++k)
-            canvas[x.r][colOffset + k] = cell[k];
+        for (int k = 0; k < cellWidth && (colOffset + k) < (int)canvas[r].size(); ++k)
+            canvas[r][colOffset + k] = cell[k];
     }
 
     std::ostringstream out;
@@ -78,96 +325,6 @@ std::string Board::render(bool showOwner, bool showArmies, int cellWidth) const
 
 // ---------- Color Rendering ----------
 std::string Board::renderColor(int cellWidth) const {
-    int maxR = 0, maxC = 0;
-    for (const auto& x : territories_) {
-        maxR = std::max(maxR, x.r);
-        maxC = std::max(maxC, x.c);
-    }
-
-    const int rows = maxR + 1, cols = maxC + 1;
-
-    auto terrAt = [&](int r, int c) -> const Territory* {
-        for (const auto& t : territories_) if (t.r == r && t.c == c) return &t;
-        return nullptr;
-    };
-
-    auto bg = [](const char* code){ return std::string("\x1b[") + code + "m"; };
-    const std::string RESET    = "\x1b[0m";
-    const std::string FG_WHITE = "\x1b[97m";
-    const std::string BG_BLACK = bg("40");
-    const std::string BG_GREY  = bg("100");
-    const std::string BG_BLUE  = bg("44");
-    const std::string BG_RED   = bg("41");
-
-    cellWidth = std::max(2, cellWidth);
-    std::string out;
-
-    for (int r = 0; r < rows; ++r) {
-        // Top line
-        for (int c = 0; c < cols; ++c) {
-            const Territory* T = terrAt(r, c);
-            std::string cell(cellWidth, ' ');
-            if (T) cell[0] = T->code;
-
-            if (!T) out += BG_BLACK;
-            else if (T->owner == PlayerId::P1) out += BG_BLUE;
-            else if (T->owner == PlayerId::P2) out += BG_RED;
-            else out += BG_GREY;
-
-            out += FG_WHITE + cell + RESET;
-        }
-        out += '\n';
-
-        // Bottom line (armies)
-        for (int c = 0; c < cols; ++c) {
-            const Territory* T = terrAt(r, c);
-            std::string cell(cellWidth, ' ');
-            if (T) {
-                std::string a = std::to_string(std::max(0, T->armies));
-                if ((int)a.size() > cellWidth) a = a.substr(a.size() - cellWidth);
-                int start = cellWidth - (int)a.size();
-                for (size_t i = 0; i < a.size(); ++i)
-                    if (start + (int)i < cellWidth)
-                        cell[start + (int)i] = a[i];
-            }
-
-            if (!T) out += BG_BLACK;
-            else if (T->owner == PlayerId::P1) out += BG_BLUE;
-            else if (T->owner == PlayerId::P2) out += BG_RED;
-            else out += BG_GREY;
-
-            out += FG_WHITE + cell + RESET;
-        }
-        out += '\n';
-    }
-
-    return out;
-}
-
-// ---------- Validators ----------
-bool Board::validateAdjUndirected() const {
-    for (int a = 0; a < (int)territories_.size(); ++a) {
-        for (TerrId b : territories_[a].adj) {
-            if (b < 0 || b >= (int)territories_.size()) return false;
-            const auto& back = territories_[b].adj;
-            if (std::find(back.begin(), back.end(), a) == back.end()) return false;
-        }
-    }
-    return true;
-}
-
-bool Board::validateUniqueCodesAndCoords() const {
-    std::unordered_set<char> codes;
-    struct PairHash {
-        std::size_t operator()(const std::pair<int,int>& p) const noexcept {
-            return std::hash<long long>{}((static_cast<long long>(p.first) << 32) ^ (unsigned)p.second);
-        }
-    };
-    std::unordered_set<std::pair<int,int>, PairHash> coords;
-
-    for (const auto& x : territories_) {
-        if (!codes.insert(x.code).second) return false;
-        if (!coords.insert({x.r, x.c}).second) return false;
-    }
-    return true;
+    BoardRenderer r(cellWidth);
+    return r.frame(*this);
 }
@@ -1,24 +1,93 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
+#include <memory>
+#include "Components.h"
+#include "MapTopology.h"
+#include "TerrMask.h"
 #include "Types.h"   // contains PlayerId, TerrId, Territory
 
+// ------------------------------------------------------------
+// Board
+//  • Shares an immutable MapTopology (names, positions, CSR
+//    adjacency); the game state proper is two contiguous arrays,
+//    owner and armies per territory
+//  • All state changes go through the mutation API below
+//  • Keeps per-player territory counts, army totals, the frontier
+//    (owned territories touching a non-owned one) and the game
+//    status current, at O(degree) per change
+//  • Keeps per-player connected components (ComponentIndex)
+//  • Keeps a Zobrist position key (see Zobrist.h)
+// ------------------------------------------------------------
 class Board {
 public:
     // --- Constructors ---
     Board() = default;
-    explicit Board(std::vector<Territory> territories);
+    explicit Board(const std::vector<Territory>& territories);     // builds a topology
+    explicit Board(std::shared_ptr<const MapTopology> topology);   // all unowned
 
     // --- Accessors ---
-    const std::vector<Territory>& getTerritories() const;
-    std::vector<Territory>& getTerritories();
-    int count() const;
-    const Territory& at(TerrId id) const;
-    Territory& at(TerrId id);
+    const MapTopology& topology() const { return *topo_; }
+    const std::shared_ptr<const MapTopology>& sharedTopology() const { return topo_; }
+    int count() const { return static_cast<int>(armies_.size()); }
+    PlayerId owner(TerrId id) const { return static_cast<PlayerId>(owner_[id]); }
+    int armies(TerrId id) const { return armies_[id]; }
+    char code(TerrId id) const { return topo_->code(id); }
+    const std::string& name(TerrId id) const { return topo_->name(id); }
+
+    // --- Snapshots (the two state arrays; restore rebuilds tracking) ---
+    struct Snapshot {
+        std::vector<std::int8_t> owner;
+        std::vector<int> armies;
+    };
+    void save(Snapshot& out) const;
+    void restore(const Snapshot& s);
+
+    // --- Mutation ---
+    void place(TerrId id, PlayerId p, int armies);          // set up a territory
+    void addArmies(TerrId id, int n);                       // reinforcements / bonus
+    bool applyLosses(TerrId from, TerrId to,
+                     int attackerLoss, int defenderLoss);   // true if `to` is emptied
+    void capture(TerrId id, PlayerId newOwner);             // change hands (armies kept)
+    void moveArmies(TerrId from, TerrId to, int n);         // capture move / fortify
+
+    // --- Make / unmake (search without copying) ---
+    // While recording, every mutation above pushes a compact entry onto a
+    // fixed-capacity undo stack (reserved once, never reallocated), and
+    // undoTo(mark) reverts the board to the moment undoMark() returned
+    // `mark`. Consecutive rounds of one battle share an entry (never
+    // across a mark). If the stack overflows, later undoTo() calls return
+    // false: the board can no longer be restored and must be rebuilt.
+    static constexpr int kMaxUndo = 4096;
+    void beginRecording();                 // clears the stack
+    void endRecording();
+    int undoMark() { return sealed_ = static_cast<int>(undo_.size()); }
+    int undoRoom() const { return kMaxUndo - static_cast<int>(undo_.size()); }
+    bool undoTo(int mark);
+
+    // --- Tracked aggregates (O(1)) ---
+    int ownedCount(PlayerId p) const { return owned_[static_cast<int>(p)]; }
+    int armyTotal(PlayerId p) const { return armyTotal_[static_cast<int>(p)]; }
+    GameState status() const;
+    const std::vector<TerrId>& frontier(PlayerId p) const { return frontier_[static_cast<int>(p)]; }
+    bool onFrontier(TerrId id) const { return frontierSide_[id] >= 0; }
+    const ComponentIndex& components() const { return comps_; }
+
+    // --- Position keys (Zobrist, updated by every mutation) ---
+    std::uint64_t hash(PlayerId toMove) const;            // owners + armies + side
+    std::uint64_t ownershipHash(PlayerId toMove) const;   // owners + side only
 
     // --- Adjacency helpers ---
-    const std::vector<TerrId>& neighbors(TerrId id) const;
-    bool areAdjacent(TerrId a, TerrId b) const;
+    NeighborRange neighbors(TerrId id) const { return topo_->neighbors(id); }
+    bool areAdjacent(TerrId a, TerrId b) const { return topo_->areAdjacent(a, b); }
+
+    // --- Bitboard (maps of at most TerrMask::kBits territories) ---
+    bool hasMasks() const { return topo_->hasMasks(); }
+    const TerrMask& allMask() const { return topo_->allMask(); }
+    const TerrMask& adjMask(TerrId id) const { return topo_->adjMask(id); }
+    const TerrMask& ownerMask(PlayerId p) const { return ownerMask_[static_cast<int>(p)]; }
+    const TerrMask& frontierMask(PlayerId p) const { return frontierMask_[static_cast<int>(p)]; }
 
     // --- Rendering ---
     std::string render(bool showOwner = false,
@@ -28,9 +97,46 @@ public:
     std::string renderColor(int cellWidth = 3) const;
 
     // --- Validators ---
-    bool validateAdjUndirected() const;
-    bool validateUniqueCodesAndCoords() const;
+    bool validateAdjUndirected() const { return topo_->validateAdjUndirected(); }
+    bool validateUniqueCodesAndCoords() const { return topo_->validateUniqueCodesAndCoords(); }
+    bool validateTracking() const;       // incremental state == full recount
 
 private:
-    std::vector<Territory> territories_;
+    struct UndoEntry {
+        enum Kind : std::uint8_t { Armies, Losses, Owner, Move, Place };
+        Kind kind;
+        std::int8_t prevOwner;      // Owner / Place
+        TerrId a, b;
+        int n, m;                   // armies (Losses: attacker, defender)
+    };
+
+    void record(const UndoEntry& e);
+    void rebuildTracking();
+    void setOwner(TerrId id, PlayerId p);
+    void addArmyTotal(PlayerId p, int n);
+    void setArmies(TerrId id, int n);      // keeps totals and hash current
+    void refreshFrontier(TerrId id);
+
+    std::shared_ptr<const MapTopology> topo_;
+    std::vector<std::int8_t> owner_;          // PlayerId per territory
+    std::vector<int> armies_;
+
+    // Incremental aggregates, indexed by PlayerId::P1 / P2
+    int owned_[2]{0, 0};
+    int armyTotal_[2]{0, 0};
+    std::vector<int> foreign_;                // neighbours held by someone else
+    std::vector<TerrId> frontier_[2];         // unordered sets with O(1) removal:
+    std::vector<int> frontierPos_;            //   index in frontier_[side]
+    std::vector<signed char> frontierSide_;   //   side holding it (-1 = none)
+    ComponentIndex comps_;
+    std::uint64_t ownerHash_{0};
+    std::uint64_t armyHash_{0};
+
+    std::vector<UndoEntry> undo_;
+    int sealed_{0};                           // entries below may not coalesce
+    bool recording_{false};
+    bool undoLost_{false};
+
+    TerrMask ownerMask_[2];
+    TerrMask frontierMask_[2];
 };
@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+
+// ------------------------------------------------------------
+// Budget — compute allowance for one AI decision
+// ------------------------------------------------------------
+// A decision stops at whichever limit it reaches first: `work`
+// units (MCTS: playouts, all threads together) or `timeMs` of
+// wall clock. Searches are anytime, so stopping early still
+// returns the best candidate found so far. Difficulty levels are
+// named budgets: interactive levels carry a latency bound, while
+// Analysis has none and uses all the work it is given.
+//
+struct Budget {
+    int work{0};                 // 0 = no work cap
+    double timeMs{0.0};          // 0 = no deadline
+
+    bool bounded() const { return work > 0 || timeMs > 0.0; }
+};
+
+enum class Difficulty { Easy, Normal, Hard, Analysis };
+
+inline Budget budgetFor(Difficulty d) {
+    switch (d) {
+        case Difficulty::Easy:     return {200, 25.0};
+        case Difficulty::Normal:   return {2000, 150.0};
+        case Difficulty::Hard:     return {12000, 1000.0};
+        case Difficulty::Analysis: return {200000, 0.0};
+    }
+    return {};
+}
+
+inline const char* name(Difficulty d) {
+    switch (d) {
+        case Difficulty::Easy:     return "easy";
+        case Difficulty::Normal:   return "normal";
+        case Difficulty::Hard:     return "hard";
+        case Difficulty::Analysis: return "analysis";
+    }
+    return "?";
+}
+
+inline bool parseDifficulty(const std::string& s, Difficulty& out) {
+    for (Difficulty d : {Difficulty::Easy, Difficulty::Normal, Difficulty::Hard, Difficulty::Analysis})
+        if (s == name(d)) { out = d; return true; }
+    return false;
+}
@@ -0,0 +1,221 @@
+#include "Components.h"
+#include "Board.h"
+#include <algorithm>
+
+// ---------- Copies ----------
+// A vector copy gets only the capacity it needs, so copies reserve
+// again; the scratch buffers are not copied.
+ComponentIndex::ComponentIndex(const ComponentIndex& o)
+    : label_(o.label_), comps_(o.comps_), freeList_(o.freeList_),
+      ranked_{o.ranked_[0], o.ranked_[1]} {
+    reserve(label_.size());
+}
+
+ComponentIndex& ComponentIndex::operator=(const ComponentIndex& o) {
+    label_ = o.label_;
+    comps_ = o.comps_;
+    freeList_ = o.freeList_;
+    ranked_[0] = o.ranked_[0];
+    ranked_[1] = o.ranked_[1];
+    reserve(label_.size());
+    return *this;
+}
+
+// Live components never exceed n + 1 (a split's pieces exist before
+// the old component is retired), and neither does any scratch list.
+void ComponentIndex::reserve(std::size_t territories) {
+    const std::size_t cap = territories + 1;
+    comps_.reserve(cap);
+    freeList_.reserve(cap);
+    ranked_[0].reserve(cap);
+    ranked_[1].reserve(cap);
+    queue_.reserve(cap);
+    nbrs_.reserve(cap);
+    parent_.reserve(cap);
+}
+
+// ---------- Full build ----------
+void ComponentIndex::build(const Board& b) {
+    const int n = b.count();
+    label_.assign(n, -1);
+    comps_.clear();
+    freeList_.clear();
+    ranked_[0].clear();
+    ranked_[1].clear();
+    reserve(static_cast<std::size_t>(n));
+
+    for (int i = 0; i < n; ++i) {
+        PlayerId o = b.owner(i);
+        if (o == PlayerId::None || label_[i] >= 0) continue;
+        int c = newComp(o);
+        queue_.assign(1, i);
+        label_[i] = c;
+        for (size_t h = 0; h < queue_.size(); ++h)
+            for (TerrId v : b.neighbors(queue_[h]))
+                if (label_[v] < 0 && b.owner(v) == o) { label_[v] = c; queue_.push_back(v); }
+        setStats(c, static_cast<int>(queue_.size()), i);   // BFS starts at the smallest id
+    }
+}
+
+// ---------- Incremental update ----------
+void ComponentIndex::onOwnerChange(const Board& b, TerrId id, PlayerId oldOwner, PlayerId newOwner) {
+    if (oldOwner == newOwner) return;
+
+    // ----- Losing side -----
+    if (oldOwner != PlayerId::None) {
+        const int c = label_[id];
+        label_[id] = -1;
+
+        auto& nbrs = nbrs_;
+        nbrs.clear();
+        for (TerrId v : b.neighbors(id))
+            if (label_[v] == c && std::find(nbrs.begin(), nbrs.end(), v) == nbrs.end())
+                nbrs.push_back(v);
+
+        if (nbrs.empty()) {
+            freeComp(c);
+        } else if (cannotSplit(b, id, oldOwner, nbrs)) {
+            TerrId minId = comps_[c].minId;
+            int size = comps_[c].size - 1;
+            if (minId == id) {                // min left: rescan the component
+                minId = nbrs[0];
+                relabel(b, nbrs[0], c, c, minId);
+            }
+            setStats(c, size, minId);
+        } else {
+            // Local re-BFS: every piece reachable from a neighbour gets a
+            // fresh label, then the old component is retired.
+            for (TerrId v : nbrs) {
+                if (label_[v] != c) continue;            // already in an earlier piece
+                int piece = newComp(oldOwner);
+                TerrId minId = v;
+                int size = relabel(b, v, c, piece, minId);
+                setStats(piece, size, minId);
+            }
+            freeComp(c);
+        }
+    }
+
+    // ----- Gaining side -----
+    if (newOwner != PlayerId::None) {
+        int best = -1;
+        for (TerrId v : b.neighbors(id)) {
+            int l = label_[v];
+            if (l < 0 || comps_[l].owner != newOwner) continue;
+            if (best < 0 || comps_[l].size > comps_[best].size) best = l;
+        }
+        if (best < 0) {
+            int c = newComp(newOwner);
+            label_[id] = c;
+            setStats(c, 1, id);
+            return;
+        }
+
+        label_[id] = best;
+        int size = comps_[best].size + 1;
+        TerrId minId = std::min(comps_[best].minId, id);
+        for (TerrId v : b.neighbors(id)) {
+            int l = label_[v];
+            if (l < 0 || l == best || comps_[l].owner != newOwner) continue;
+            size += comps_[l].size;
+            minId = std::min(minId, comps_[l].minId);
+            TerrId ignored = v;
+            relabel(b, v, l, best, ignored);
+            freeComp(l);
+        }
+        setStats(best, size, minId);
+    }
+}
+
+// ---------- Queries ----------
+bool ComponentIndex::largest(PlayerId p, int& size, TerrId& minId) const {
+    const auto& r = ranked_[static_cast<int>(p)];
+    if (r.empty()) return false;
+    size = -r.front().first;
+    minId = r.front().second;
+    return true;
+}
+
+// ---------- Helpers ----------
+int ComponentIndex::newComp(PlayerId owner) {
+    int c;
+    if (!freeList_.empty()) { c = freeList_.back(); freeList_.pop_back(); }
+    else { c = static_cast<int>(comps_.size()); comps_.emplace_back(); }
+    comps_[c] = Comp{owner, 0, -1};
+    return c;
+}
+
+void ComponentIndex::freeComp(int c) {
+    Comp& k = comps_[c];
+    if (k.size > 0) unrank(k.owner, {-k.size, k.minId});
+    k = Comp{};
+    freeList_.push_back(c);
+}
+
+void ComponentIndex::setStats(int c, int size, TerrId minId) {
+    Comp& k = comps_[c];
+    if (k.size > 0) unrank(k.owner, {-k.size, k.minId});
+    k.size = size;
+    k.minId = minId;
+    if (size > 0) rank(k.owner, {-size, minId});
+}
+
+// Keys are unique (one minId per component); both stay within the
+// capacity build() reserved.
+void ComponentIndex::rank(PlayerId p, Key k) {
+    auto& r = ranked_[static_cast<int>(p)];
+    r.insert(std::lower_bound(r.begin(), r.end(), k), k);
+}
+
+void ComponentIndex::unrank(PlayerId p, Key k) {
+    auto& r = ranked_[static_cast<int>(p)];
+    r.erase(std::lower_bound(r.begin(), r.end(), k));
+}
+
+// BFS from `start` over territories labelled `from`, relabelling them `to`.
+// Returns the number visited and lowers minId to the smallest id seen.
+// With from == to it only walks (nodes are tracked by a temporary -2 mark).
+int ComponentIndex::relabel(const Board& b, TerrId start, int from, int to, TerrId& minId) {
+    const int tmp = (from == to) ? -2 : to;
+    queue_.clear();
+    queue_.push_back(start);
+    label_[start] = tmp;
+    for (size_t h = 0; h < queue_.size(); ++h) {
+        TerrId u = queue_[h];
+        minId = std::min(minId, u);
+        for (TerrId v : b.neighbors(u))
+            if (label_[v] == from) { label_[v] = tmp; queue_.push_back(v); }
+    }
+    if (tmp != to)
+        for (TerrId u : queue_) label_[u] = to;
+    return static_cast<int>(queue_.size());
+}
+
+// Removing `id` cannot disconnect its component if its same-owner
+// neighbours stay linked to each other — directly or through a common
+// same-owner neighbour other than `id`.
+bool ComponentIndex::cannotSplit(const Board& b, TerrId id, PlayerId owner,
+                                 const std::vector<TerrId>& nbrs) {
+    const int k = static_cast<int>(nbrs.size());
+    if (k <= 1) return true;
+
+    auto linked = [&](TerrId x, TerrId y) {
+        if (b.areAdjacent(x, y)) return true;
+        for (TerrId w : b.neighbors(x))
+            if (w != id && b.owner(w) == owner && b.areAdjacent(w, y)) return true;
+        return false;
+    };
+
+    // Tiny union-find over the neighbour list.
+    std::vector<int>& parent = parent_;
+    parent.resize(static_cast<std::size_t>(k));
+    for (int i = 0; i < k; ++i) parent[i] = i;
+    auto find = [&](int x) { while (parent[x] != x) x = parent[x] = parent[parent[x]]; return x; };
+    int groups = k;
+    for (int i = 0; i < k && groups > 1; ++i)
+        for (int j = i + 1; j < k && groups > 1; ++j) {
+            int a = find(i), c = find(j);
+            if (a != c && linked(nbrs[i], nbrs[j])) { parent[a] = c; --groups; }
+        }
+    return groups == 1;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Types.h"
+
+class Board;
+
+// ------------------------------------------------------------
+// ComponentIndex — connected groups of same-owner territories
+// ------------------------------------------------------------
+// Labels every owned territory with its component and tracks each
+// component's size and smallest TerrId, plus a per-player ranking
+// by (size desc, min id asc). Board calls onOwnerChange() after a
+// territory changes hands:
+//   • gaining side: join / merge the neighbouring components
+//     (smaller ones are relabelled into the largest)
+//   • losing side: a cheap local test proves most removals cannot
+//     split the component; otherwise the old component is re-BFSed
+//     locally and split into its pieces
+// Queries ("same component?", "largest chain") are O(1).
+// build() reserves every buffer for the board's size, so updates
+// (and undoing them) never allocate; the ranking is a sorted vector
+// shifted in place rather than a node-based set.
+//
+class ComponentIndex {
+public:
+    ComponentIndex() = default;
+    ComponentIndex(const ComponentIndex& o);              // keeps the reserve
+    ComponentIndex& operator=(const ComponentIndex& o);
+    ComponentIndex(ComponentIndex&&) noexcept = default;
+    ComponentIndex& operator=(ComponentIndex&&) noexcept = default;
+
+    void build(const Board& b);
+    void onOwnerChange(const Board& b, TerrId id, PlayerId oldOwner, PlayerId newOwner);
+
+    // True if a and b are owned by the same player and connected through it.
+    bool connected(TerrId a, TerrId b) const {
+        return label_[a] >= 0 && label_[a] == label_[b];
+    }
+    int componentSize(TerrId id) const {
+        return label_[id] >= 0 ? comps_[label_[id]].size : 0;
+    }
+
+    // Largest component of p (ties: smallest min id). False if p owns nothing.
+    bool largest(PlayerId p, int& size, TerrId& minId) const;
+
+    int componentCount(PlayerId p) const {
+        return static_cast<int>(ranked_[static_cast<int>(p)].size());
+    }
+
+private:
+    struct Comp {
+        PlayerId owner{PlayerId::None};
+        int size{0};
+        TerrId minId{-1};
+    };
+    using Key = std::pair<int, TerrId>;   // (-size, minId)
+
+    void reserve(std::size_t territories);
+    int newComp(PlayerId owner);
+    void freeComp(int c);
+    void setStats(int c, int size, TerrId minId);
+    void rank(PlayerId p, Key k);
+    void unrank(PlayerId p, Key k);
+    int relabel(const Board& b, TerrId start, int from, int to, TerrId& minId);
+    bool cannotSplit(const Board& b, TerrId id, PlayerId owner, const std::vector<TerrId>& nbrs);
+
+    std::vector<int> label_;                 // component per territory (-1 = unowned)
+    std::vector<Comp> comps_;
+    std::vector<int> freeList_;
+    std::vector<Key> ranked_[2];             // sorted; indexed by PlayerId::P1 / P2
+    std::vector<TerrId> queue_;              // BFS scratch
+    std::vector<TerrId> nbrs_;               // same-owner neighbours of a removed territory
+    std::vector<int> parent_;                // cannotSplit union-find scratch
+};
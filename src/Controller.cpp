@@ -0,0 +1,55 @@
+#include "Controller.h"
+#include "RandomAI.h"
+#include <string>
+
+// ---------- HumanController ----------
+TerrId HumanController::chooseReinforcement(const Board& b, PlayerId p, int reinforcements) {
+    IO::println("Reinforcements: " + std::to_string(reinforcements));
+    return IO::readOwnedTerritory(b, p, "Place ALL reinforcements at (code): ");
+}
+
+bool HumanController::chooseAttack(const Board& b, PlayerId p, int /*attacksSoFar*/,
+                                   IO::AttackChoice& out) {
+    if (IO::readYesNo("Attack?") != 'y') return false;
+    out = IO::readAttackChoice(b, p);
+    return true;
+}
+
+int HumanController::chooseMoveAfterCapture(const Board& b, TerrId /*from*/, TerrId to, int maxMove) {
+    IO::println("Captured " + b.name(to) + "!");
+    return IO::readIntInRange("Move how many armies?", 1, maxMove);
+}
+
+bool HumanController::chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) {
+    if (IO::readYesNo("Fortify?") != 'y') return false;
+    out = IO::readFortifyChoice(b, p);
+    return true;
+}
+
+// ---------- RandomAIController ----------
+RandomAIController::RandomAIController(std::uint32_t seed, ThreadPool* pool)
+    : seed_(seed), rng_(seed), pool_(pool) {}
+
+TerrId RandomAIController::chooseReinforcement(const Board& b, PlayerId p, int reinforcements) {
+    return RandomAI::chooseReinforcement(b, p, reinforcements, seed_++);
+}
+
+bool RandomAIController::chooseAttack(const Board& b, PlayerId p, int attacksSoFar,
+                                      IO::AttackChoice& out) {
+    if (attacksSoFar >= kMaxAttacksPerTurn) return false;
+    auto plan = RandomAI::chooseAttack(b, p, seed_++, pool_);
+    if (!plan.valid) return false;
+    out = {plan.from, plan.to};
+    return true;
+}
+
+int RandomAIController::chooseMoveAfterCapture(const Board&, TerrId, TerrId, int maxMove) {
+    return 1 + static_cast<int>(rng_.below(static_cast<std::uint32_t>(maxMove)));
+}
+
+bool RandomAIController::chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) {
+    auto plan = RandomAI::chooseFortify(b, p, seed_++, pool_);
+    if (!plan.valid) return false;
+    out = {plan.from, plan.to, plan.amount};
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include "Board.h"
+#include "IO.h"
+#include "Rng.h"
+#include "Types.h"
+
+class ThreadPool;
+
+// ------------------------------------------------------------
+// Controller — decides one player's moves
+//  • Game::play asks the controller at every decision point
+//  • HumanController reads from the console (IO::read*)
+//  • RandomAIController wraps RandomAI::choose*
+// ------------------------------------------------------------
+class Controller {
+public:
+    virtual ~Controller() = default;
+
+    // Owned territory that receives ALL reinforcements (-1 = none).
+    virtual TerrId chooseReinforcement(const Board& b, PlayerId p, int reinforcements) = 0;
+
+    // Next attack of this turn; returns false to stop attacking.
+    // attacksSoFar counts the battles already fought this turn.
+    virtual bool chooseAttack(const Board& b, PlayerId p, int attacksSoFar,
+                              IO::AttackChoice& out) = 0;
+
+    // Armies to move into a just-captured territory, in [1, maxMove].
+    virtual int chooseMoveAfterCapture(const Board& b, TerrId from, TerrId to, int maxMove) = 0;
+
+    // Fortify move for the end of the turn; returns false to skip.
+    virtual bool chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) = 0;
+};
+
+// ---------- Console player ----------
+class HumanController : public Controller {
+public:
+    TerrId chooseReinforcement(const Board& b, PlayerId p, int reinforcements) override;
+    bool chooseAttack(const Board& b, PlayerId p, int attacksSoFar,
+                      IO::AttackChoice& out) override;
+    int chooseMoveAfterCapture(const Board& b, TerrId from, TerrId to, int maxMove) override;
+    bool chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) override;
+};
+
+// ---------- RandomAI player ----------
+class RandomAIController : public Controller {
+public:
+    static constexpr int kMaxAttacksPerTurn = 6;
+
+    // `pool` (not owned) fans out scoring on very large boards.
+    explicit RandomAIController(std::uint32_t seed, ThreadPool* pool = nullptr);
+
+    TerrId chooseReinforcement(const Board& b, PlayerId p, int reinforcements) override;
+    bool chooseAttack(const Board& b, PlayerId p, int attacksSoFar,
+                      IO::AttackChoice& out) override;
+    int chooseMoveAfterCapture(const Board& b, TerrId from, TerrId to, int maxMove) override;
+    bool chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) override;
+
+private:
+    std::uint32_t seed_;   // advanced once per RandomAI call
+    Rng::Stream rng_;      // capture-move amounts
+    ThreadPool* pool_;
+};
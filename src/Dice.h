@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Dice — allocation-free dice round kernel
+// ------------------------------------------------------------
+// Every (attDice, defDice) round has at most three outcomes
+// (attacker loses 0, 1 or 2 of the compared pairs). Their exact
+// frequencies are enumerated at compile time, and a round is then
+// sampled from ONE uniform 32-bit draw by comparing it against
+// cumulative thresholds — no vectors, no sorting. Threshold
+// rounding biases each outcome by less than 2^-32.
+//
+namespace Dice {
+
+    struct RoundTable {
+        int total[3][2];               // 6^(a+d) equally likely rolls
+        int count[3][2][3];            // rolls where the attacker loses i
+        std::uint32_t cut[3][2][2];    // u < cut[0]: loses 0; u < cut[1]: loses 1
+    };
+
+    namespace detail {
+        constexpr void sortDesc(int* v, int n) {
+            for (int i = 1; i < n; ++i)
+                for (int j = i; j > 0 && v[j - 1] < v[j]; --j) {
+                    int t = v[j]; v[j] = v[j - 1]; v[j - 1] = t;
+                }
+        }
+
+        constexpr RoundTable makeRoundTable() {
+            RoundTable t{};
+            for (int a = 1; a <= 3; ++a)
+                for (int d = 1; d <= 2; ++d) {
+                    int total = 1;
+                    for (int k = 0; k < a + d; ++k) total *= 6;
+                    int counts[3] = {0, 0, 0};
+                    for (int code = 0; code < total; ++code) {
+                        int A[3] = {0, 0, 0}, D[2] = {0, 0};
+                        int c = code;
+                        for (int k = 0; k < a; ++k) { A[k] = c % 6 + 1; c /= 6; }
+                        for (int k = 0; k < d; ++k) { D[k] = c % 6 + 1; c /= 6; }
+                        sortDesc(A, a);
+                        sortDesc(D, d);
+                        int lost = 0;
+                        for (int k = 0; k < (a < d ? a : d); ++k)
+                            if (A[k] <= D[k]) ++lost;   // ties defend
+                        ++counts[lost];
+                    }
+                    t.total[a - 1][d - 1] = total;
+                    std::uint64_t cum = 0;
+                    for (int i = 0; i < 3; ++i) {
+                        t.count[a - 1][d - 1][i] = counts[i];
+                        if (i < 2) {
+                            cum += static_cast<std::uint64_t>(counts[i]);
+                            std::uint64_t c = (cum << 32) / static_cast<std::uint64_t>(total);
+                            t.cut[a - 1][d - 1][i] = c > 0xFFFFFFFFull ? 0xFFFFFFFFu
+                                                                       : static_cast<std::uint32_t>(c);
+                        }
+                    }
+                }
+            return t;
+        }
+    } // namespace detail
+
+    inline constexpr RoundTable kRound = detail::makeRoundTable();
+
+    // Exact probability that the attacker loses `attLoss` in one round.
+    constexpr double lossProb(int attDice, int defDice, int attLoss) {
+        return static_cast<double>(kRound.count[attDice - 1][defDice - 1][attLoss]) /
+               kRound.total[attDice - 1][defDice - 1];
+    }
+
+    // Attacker losses for one round from a uniform 32-bit draw `u`
+    // (dice counts must be in 1..3 / 1..2); the defender loses the rest
+    // of min(attDice, defDice).
+    inline int attackerLosses(int attDice, int defDice, std::uint32_t u) {
+        const std::uint32_t* c = kRound.cut[attDice - 1][defDice - 1];
+        int twoPairs = (attDice > 1 && defDice > 1);
+        return static_cast<int>(u >= c[0]) + (twoPairs & static_cast<int>(u >= c[1]));
+    }
+
+} // namespace Dice
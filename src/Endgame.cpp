@@ -0,0 +1,501 @@
+#include "Endgame.h"
+#include "BattleOdds.h"
+#include "Instrument.h"
+#include "Rules.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using Endgame::Value;
+
+constexpr char kMagic[4] = {'M', 'R', 'E', 'T'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 32;          // magic, 5 × u32, u64 map key
+constexpr std::size_t kMemoLimit = 1u << 22;     // entries before the memo starts over
+
+Value flip(const Value& v) { return {v.loss, v.win}; }
+bool better(const Value& a, const Value& b) { return a.score() > b.score() + 1e-12; }
+
+// Value for p of a finished game; false while it goes on.
+bool over(const Board& b, PlayerId p, Value& v) {
+    const GameState s = b.status();
+    if (s != GameState::Player1Wins && s != GameState::Player2Wins) return false;
+    v = ((s == GameState::Player1Wins) == (p == PlayerId::P1)) ? Value{1.0, 0.0} : Value{0.0, 1.0};
+    return true;
+}
+
+// Necessary for p to win this turn: an army left on every territory.
+// Armies only fall during a turn, apart from the reinforcements.
+bool canWinThisTurn(const Board& b, PlayerId p) {
+    return b.armyTotal(p) + Rules::baseReinforcements(b, p) + 5 >= b.count();
+}
+
+bool touchesEnemy(const Board& b, TerrId t, PlayerId p) {
+    for (TerrId n : b.neighbors(t))
+        if (b.owner(n) == other(p)) return true;
+    return false;
+}
+
+std::uint64_t readFixed(const std::uint8_t* p, int bytes) {
+    std::uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+void writeFixed(std::uint8_t* p, std::uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+}
+
+std::size_t power(int base, int exp) {
+    std::size_t r = 1;
+    while (exp-- > 0) r *= static_cast<std::size_t>(base);
+    return r;
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+namespace Endgame {
+
+std::uint64_t topologyKey(const MapTopology& m) {
+    std::uint64_t h = splitmix64(static_cast<std::uint64_t>(m.count()));
+    for (TerrId t = 0; t < m.count(); ++t)
+        for (TerrId n : m.neighbors(t))
+            h = splitmix64(h ^ (static_cast<std::uint64_t>(t) << 32 | static_cast<std::uint32_t>(n)));
+    return h;
+}
+
+// ---------- Table ----------
+Table::~Table() { close(); }
+
+void Table::close() {
+    if (mapped_ && data_) munmap(const_cast<std::uint8_t*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
+
+bool Table::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < kHeaderSize) {
+        ::close(fd);
+        return false;
+    }
+    void* m = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (m == MAP_FAILED) return false;
+    data_ = static_cast<const std::uint8_t*>(m);
+    size_ = static_cast<std::size_t>(st.st_size);
+    mapped_ = true;
+
+    territories_ = static_cast<int>(readFixed(data_ + 8, 4));
+    maxArmies_ = static_cast<int>(readFixed(data_ + 12, 4));
+    horizon_ = static_cast<int>(readFixed(data_ + 16, 4));
+    blitz_ = readFixed(data_ + 20, 4) != 0;
+    mapKey_ = readFixed(data_ + 24, 8);
+    const bool sane = std::memcmp(data_, kMagic, 4) == 0 && readFixed(data_ + 4, 4) == kVersion &&
+                      territories_ >= 1 && territories_ <= kMaxTerritories &&
+                      maxArmies_ >= 1 && maxArmies_ <= 255 && horizon_ >= 1 && horizon_ <= 16;
+    if (!sane || size_ != kHeaderSize + 4 * static_cast<std::size_t>(horizon_) *
+                                           (std::size_t{1} << territories_) *
+                                           power(maxArmies_, territories_)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool Table::lookup(const Board& b, PlayerId p, int turnsLeft, Value& out) const {
+    if (!data_ || turnsLeft < 1 || turnsLeft > horizon_ || b.count() != territories_) return false;
+    std::size_t mask = 0, idx = 0;
+    for (TerrId t = territories_ - 1; t >= 0; --t) {
+        const int a = b.armies(t);
+        if (a < 1 || a > maxArmies_ || b.owner(t) == PlayerId::None) return false;
+        idx = idx * static_cast<std::size_t>(maxArmies_) + static_cast<std::size_t>(a - 1);
+        mask = (mask << 1) | (b.owner(t) == p ? 1u : 0u);
+    }
+    const std::size_t layer = static_cast<std::size_t>(turnsLeft - 1);
+    const std::size_t entry = ((layer << territories_) | mask) * power(maxArmies_, territories_) + idx;
+    const std::uint8_t* e = data_ + kHeaderSize + 4 * entry;
+    out.win = static_cast<double>(readFixed(e, 2)) / 65535.0;
+    out.loss = static_cast<double>(readFixed(e + 2, 2)) / 65535.0;
+    return true;
+}
+
+std::size_t Table::build(const std::shared_ptr<const MapTopology>& map, int maxArmies,
+                         const Config& cfg, const std::string& path) {
+    const int n = map->count();
+    if (n < 1 || n > kMaxTerritories || maxArmies < 1 || maxArmies > 255 ||
+        cfg.horizon < 1 || cfg.horizon > 16)
+        return 0;
+    const std::size_t perMask = power(maxArmies, n);
+    const std::size_t perLayer = perMask << n;
+    std::vector<std::uint8_t> buf(kHeaderSize + 4 * perLayer * static_cast<std::size_t>(cfg.horizon));
+    std::memcpy(buf.data(), kMagic, 4);
+    writeFixed(buf.data() + 4, kVersion, 4);
+    writeFixed(buf.data() + 8, static_cast<std::uint64_t>(n), 4);
+    writeFixed(buf.data() + 12, static_cast<std::uint64_t>(maxArmies), 4);
+    writeFixed(buf.data() + 16, static_cast<std::uint64_t>(cfg.horizon), 4);
+    writeFixed(buf.data() + 20, cfg.blitz ? 1 : 0, 4);
+    writeFixed(buf.data() + 24, topologyKey(*map), 8);
+
+    // The finished layers, readable while the next one is solved.
+    Table done;
+    done.data_ = buf.data();
+    done.size_ = buf.size();
+    done.territories_ = n;
+    done.maxArmies_ = maxArmies;
+    done.blitz_ = cfg.blitz;
+    done.mapKey_ = topologyKey(*map);
+
+    Board b(map);
+    std::size_t solved = 0;
+    for (int left = 1; left <= cfg.horizon; ++left) {
+        Config c = cfg;
+        c.horizon = left;
+        c.nodeBudget = 0;
+        Solver solver(c);
+        solver.setTable(&done);
+        for (std::size_t mask = 0; mask < (std::size_t{1} << n); ++mask) {
+            for (std::size_t idx = 0; idx < perMask; ++idx) {
+                std::size_t rest = idx;
+                for (TerrId t = 0; t < n; ++t) {
+                    b.place(t, (mask >> t) & 1 ? PlayerId::P1 : PlayerId::P2,
+                            static_cast<int>(rest % static_cast<std::size_t>(maxArmies)) + 1);
+                    rest /= static_cast<std::size_t>(maxArmies);
+                }
+                Value v;
+                solver.solve(b, Spot{Stage::Turn, PlayerId::P1}, v);
+                std::uint8_t* e = buf.data() + kHeaderSize +
+                                  4 * ((static_cast<std::size_t>(left - 1) << n | mask) * perMask + idx);
+                writeFixed(e, static_cast<std::uint64_t>(std::lround(v.win * 65535.0)), 2);
+                writeFixed(e + 2, static_cast<std::uint64_t>(std::lround(v.loss * 65535.0)), 2);
+                ++solved;
+            }
+        }
+        done.horizon_ = left;
+    }
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return 0;
+    const bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    return (std::fclose(f) == 0 && ok) ? solved : 0;
+}
+
+// ---------- Solver ----------
+Solver::Solver(Config cfg) : cfg_(cfg) {}
+
+void Solver::setTable(const Table* t) {
+    table_ = t;
+    map_.reset();                         // re-checked against the next board
+}
+
+void Solver::clear() {
+    memo_.clear();
+}
+
+bool Solver::inRange(const Board& b) const {
+    const PlayerId few = b.ownedCount(PlayerId::P1) <= b.ownedCount(PlayerId::P2) ? PlayerId::P1
+                                                                                   : PlayerId::P2;
+    if (b.count() > Table::kMaxTerritories && b.ownedCount(few) > cfg_.maxMinority) return false;
+    // The contested material: the smaller side and the enemy armies
+    // next to it (the majority's frontier borders only that side).
+    int contested = b.armyTotal(few);
+    for (TerrId t : b.frontier(other(few))) contested += b.armies(t);
+    return contested <= cfg_.maxContested;
+}
+
+bool Solver::solve(const Board& b, const Spot& at, Value& value, Choice* best) {
+    if (b.sharedTopology() != map_) {
+        map_ = b.sharedTopology();
+        memo_.clear();
+        tableFits_ = table_ && table_->territories() == b.count() &&
+                     table_->blitz() == cfg_.blitz && table_->mapKey() == topologyKey(*map_);
+    }
+
+    if (memo_.size() > kMemoLimit) memo_.clear();
+
+    board_ = b;
+    board_.beginRecording();
+    nodes_ = 0;
+    aborted_ = false;
+    if (best) *best = Choice{};
+
+    const int left = cfg_.horizon;
+    Value v;
+    switch (at.stage) {
+        case Stage::Turn:      v = turnStart(at.player, left); break;
+        case Stage::Reinforce: v = reinforce(at.player, at.amount, left, best); break;
+        case Stage::Attack:    v = attack(at.player, left, best); break;
+        case Stage::Move:      v = move(at.player, at.from, at.to, left, best); break;
+        case Stage::Fortify:   v = fortify(at.player, left, best); break;
+    }
+    board_.endRecording();
+    MR_COUNT_N(kEndgameNodes, nodes_);
+    if (aborted_) return false;
+    value = v;
+    return true;
+}
+
+// ---------- Search ----------
+Value Solver::turnStart(PlayerId p, int left) {
+    Value v;
+    if (over(board_, p, v)) return v;
+    if (left <= 0 || (left == 1 && !canWinThisTurn(board_, p))) return {};
+    if (tableFits_ && table_->lookup(board_, p, left, v)) return v;
+    const std::uint64_t k = key(p, Stage::Turn, left);
+    if (recall(k, v) || !expand()) return v;
+
+    // Game::beginTurn: the chain bonus lands before the reinforcement decision.
+    const int mark = board_.undoMark();
+    TerrId bonus = -1;
+    if (Rules::chainOf5BonusTarget(board_, p, bonus)) board_.addArmies(bonus, 5);
+    v = reinforce(p, Rules::baseReinforcements(board_, p), left, nullptr);
+    if (!board_.undoTo(mark)) aborted_ = true;
+    remember(k, v);
+    return v;
+}
+
+Value Solver::reinforce(PlayerId p, int amount, int left, Choice* best) {
+    Value v;
+    const std::uint64_t k = key(p, Stage::Reinforce, left, amount);
+    if ((!best && recall(k, v)) || !expand()) return v;
+
+    const bool q = quiet(p, left);
+    bool any = false;
+    for (TerrId t = 0; t < board_.count() && !aborted_; ++t) {
+        if (board_.owner(t) != p || (q && !touchesEnemy(board_, t, p))) continue;
+        const int mark = board_.undoMark();
+        board_.addArmies(t, amount);
+        const Value c = attack(p, left, nullptr);
+        if (!board_.undoTo(mark)) aborted_ = true;
+        if (!any || better(c, v)) {
+            v = c;
+            any = true;
+            if (best) best->to = t;
+        }
+    }
+    remember(k, v);
+    return v;
+}
+
+Value Solver::attack(PlayerId p, int left, Choice* best) {
+    Value v;
+    if (best) best->pass = true;
+    if (settled(p, left)) return v;
+    const std::uint64_t k = key(p, Stage::Attack, left);
+    if ((!best && recall(k, v)) || !expand()) return v;
+
+    v = fortify(p, left, nullptr);        // stop attacking
+    const PlayerId enemy = other(p);
+    for (TerrId from = 0; from < board_.count() && !aborted_; ++from) {
+        if (board_.owner(from) != p || board_.armies(from) < 2 || !board_.onFrontier(from)) continue;
+        for (TerrId to : board_.neighbors(from)) {
+            if (board_.owner(to) != enemy) continue;
+            const Value c = battle(p, from, to, left);
+            if (better(c, v)) {
+                v = c;
+                if (best) {
+                    best->pass = false;
+                    best->from = from;
+                    best->to = to;
+                }
+            }
+        }
+    }
+    remember(k, v);
+    return v;
+}
+
+// Chance node: one dice round, or the whole battle in blitz games.
+Value Solver::battle(PlayerId p, TerrId from, TerrId to, int left) {
+    const int a = board_.armies(from), d = board_.armies(to);
+    Value v;
+    auto outcome = [&](double prob, int attLoss, int defLoss) {
+        if (prob <= 0.0 || aborted_) return;
+        const int mark = board_.undoMark();
+        Value c;
+        if (board_.applyLosses(from, to, attLoss, defLoss)) {
+            board_.capture(to, p);
+            if (!over(board_, p, c)) c = move(p, from, to, left, nullptr);
+        } else {
+            c = attack(p, left, nullptr);
+        }
+        if (!board_.undoTo(mark)) aborted_ = true;
+        v.win += prob * c.win;
+        v.loss += prob * c.loss;
+    };
+
+    if (cfg_.blitz) {
+        const BattleOdds::Outcome o = BattleOdds::distribution(a, d);
+        for (std::size_t k = 0; k < o.attackerLeft.size(); ++k)
+            outcome(o.attackerLeft[k], a - static_cast<int>(k), d);
+        for (std::size_t k = 0; k < o.defenderLeft.size(); ++k)
+            outcome(o.defenderLeft[k], a - 1, d - static_cast<int>(k));
+    } else {
+        const int ad = Rules::attackerDice(a), dd = Rules::defenderDice(d);
+        const int pairs = std::min(ad, dd);
+        for (int attLoss = 0; attLoss <= pairs; ++attLoss)
+            outcome(BattleOdds::roundLossProb(ad, dd, attLoss), attLoss, pairs - attLoss);
+    }
+    return v;
+}
+
+Value Solver::move(PlayerId p, TerrId from, TerrId to, int left, Choice* best) {
+    Value v;
+    if (best) best->amount = 1;
+    if (settled(p, left)) return v;
+    const std::uint64_t k = key(p, Stage::Move, left, 0, from, to);
+    if ((!best && recall(k, v)) || !expand()) return v;
+
+    const int most = std::max(1, board_.armies(from) - 1);
+    for (int n = 1; n <= most && !aborted_; ++n) {
+        const int mark = board_.undoMark();
+        Rules::moveAfterCapture(board_, from, to, n);
+        const Value c = attack(p, left, nullptr);
+        if (!board_.undoTo(mark)) aborted_ = true;
+        if (n == 1 || better(c, v)) {
+            v = c;
+            if (best) best->amount = n;
+        }
+    }
+    remember(k, v);
+    return v;
+}
+
+Value Solver::fortify(PlayerId p, int left, Choice* best) {
+    if (best) best->pass = true;
+    if (quiet(p, left)) return {};        // every fortify leads to the same value
+    Value v;
+    const std::uint64_t k = key(p, Stage::Fortify, left);
+    if ((!best && recall(k, v)) || !expand()) return v;
+
+    const PlayerId next = other(p);
+    v = flip(turnStart(next, left - 1));
+    const int n = board_.count();
+    for (TerrId from = 0; from < n && !aborted_; ++from) {
+        if (board_.owner(from) != p || board_.armies(from) < 2) continue;
+        for (TerrId to = 0; to < n; ++to) {
+            if (to == from || !board_.components().connected(from, to)) continue;
+            for (int amount = 1; amount < board_.armies(from) && !aborted_; ++amount) {
+                const int mark = board_.undoMark();
+                board_.moveArmies(from, to, amount);
+                const Value c = flip(turnStart(next, left - 1));
+                if (!board_.undoTo(mark)) aborted_ = true;
+                if (better(c, v)) {
+                    v = c;
+                    if (best) *best = Choice{false, from, to, amount};
+                }
+            }
+        }
+    }
+    remember(k, v);
+    return v;
+}
+
+// ---------- Helpers ----------
+// True when p's fortify (and reinforcing away from the front) cannot
+// change the value: this is the last turn searched, or the opponent's
+// next turn is the last and it cannot win it. The opponent's armies
+// and territories only shrink during p's turn, so this holds for the
+// rest of the turn once it holds.
+bool Solver::quiet(PlayerId p, int left) const {
+    return left <= 1 || (left == 2 && !canWinThisTurn(board_, other(p)));
+}
+
+// True when nothing is left to decide in p's turn: p is short of an
+// army per territory (the reinforcements are placed by now), and no
+// later turn in the horizon can change the value either.
+bool Solver::settled(PlayerId p, int left) const {
+    return board_.armyTotal(p) < board_.count() && quiet(p, left);
+}
+
+bool Solver::expand() {
+    if (aborted_) return false;
+    ++nodes_;
+    if (cfg_.nodeBudget && nodes_ > cfg_.nodeBudget) aborted_ = true;
+    return !aborted_;
+}
+
+std::uint64_t Solver::key(PlayerId p, Stage s, int left, int amount, TerrId from, TerrId to) const {
+    const std::uint64_t meta = static_cast<std::uint64_t>(s) |
+                               static_cast<std::uint64_t>(left) << 3 |
+                               static_cast<std::uint64_t>(amount & 0xFFFFF) << 8 |
+                               static_cast<std::uint64_t>(from & 0xFFFF) << 28 |
+                               static_cast<std::uint64_t>(to & 0xFFFF) << 44;
+    return splitmix64(board_.hash(p) ^ splitmix64(meta));
+}
+
+bool Solver::recall(std::uint64_t k, Value& v) const {
+    auto it = memo_.find(k);
+    if (it == memo_.end()) return false;
+    v = it->second;
+    return true;
+}
+
+void Solver::remember(std::uint64_t k, const Value& v) {
+    if (!aborted_) memo_[k] = v;
+}
+
+} // namespace Endgame
+
+// ---------- EndgameController ----------
+EndgameController::EndgameController(std::unique_ptr<Controller> fallback, Endgame::Config cfg,
+                                     const Endgame::Table* table)
+    : fallback_(std::move(fallback)), solver_(cfg) {
+    solver_.setTable(table);
+}
+
+bool EndgameController::solved(const Board& b, const Endgame::Spot& at, Endgame::Choice& c) {
+    Endgame::Value v;
+    if (gaveUp_ || !solver_.inRange(b)) return false;
+    gaveUp_ = !solver_.solve(b, at, v, &c);
+    return !gaveUp_;
+}
+
+TerrId EndgameController::chooseReinforcement(const Board& b, PlayerId p, int reinforcements) {
+    gaveUp_ = false;                      // a new turn
+    Endgame::Choice c;
+    if (solved(b, {Endgame::Stage::Reinforce, p, reinforcements}, c)) return c.to;
+    return fallback_->chooseReinforcement(b, p, reinforcements);
+}
+
+bool EndgameController::chooseAttack(const Board& b, PlayerId p, int attacksSoFar,
+                                     IO::AttackChoice& out) {
+    Endgame::Choice c;
+    if (!solved(b, {Endgame::Stage::Attack, p}, c))
+        return fallback_->chooseAttack(b, p, attacksSoFar, out);
+    if (c.pass) return false;
+    out.from = c.from;
+    out.to = c.to;
+    return true;
+}
+
+int EndgameController::chooseMoveAfterCapture(const Board& b, TerrId from, TerrId to, int maxMove) {
+    Endgame::Choice c;
+    if (solved(b, {Endgame::Stage::Move, b.owner(from), maxMove, from, to}, c)) return c.amount;
+    return fallback_->chooseMoveAfterCapture(b, from, to, maxMove);
+}
+
+bool EndgameController::chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) {
+    Endgame::Choice c;
+    if (!solved(b, {Endgame::Stage::Fortify, p}, c)) return fallback_->chooseFortify(b, p, out);
+    if (c.pass) return false;
+    out.from = c.from;
+    out.to = c.to;
+    out.amount = c.amount;
+    return true;
+}
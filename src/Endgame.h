@@ -0,0 +1,190 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "Board.h"
+#include "Controller.h"
+#include "IO.h"
+#include "Types.h"
+
+// ------------------------------------------------------------
+// Endgame — exact expectimax for small positions
+// ------------------------------------------------------------
+// Searches the real turn structure over `horizon` turns of both
+// sides. That covers the reinforcement target, each attack or the
+// decision to stop, and the capture move. Chance nodes are the
+// dice of one round, or of the whole battle (BattleOdds) in blitz
+// games. Last comes the fortify move. A value is the side to move's
+// probability of winning, and of losing, within the horizon under
+// best play by both; whatever is left is unresolved.
+//
+// Positions are memoized on the Board's Zobrist key plus the
+// decision being made. Two cuts keep the search small, and neither
+// changes a value:
+//  • A side that cannot own every territory even with all of its
+//    armies and reinforcements cannot win this turn.
+//  • When nothing after this turn can change the value (last turn
+//    of the horizon, or the opponent cannot win its next turn),
+//    fortify moves are skipped. Reinforcements then only go next
+//    to an enemy, since armies elsewhere cannot attack this turn,
+//    and a side short of an army per territory stops there.
+// A search gives up past its node budget. "In range" means a cheap
+// filter (inRange) plus finishing inside that budget.
+//
+// Not modelled: Game's draw rules (kMaxTurns, kMaxStale and
+// repetition). An endgame is assumed to be far from them.
+//
+// Table: start-of-turn values for every position of one tiny map,
+// for every owner split and armies up to a cap per territory. It is
+// built once (`endgame`) and memory-mapped read-only by any number
+// of solvers. Values are stored in 16 bits each, to within 1/65535.
+//
+namespace Endgame {
+
+    struct Value {
+        double win{0.0};                 // side to move wins within the horizon
+        double loss{0.0};                // ... loses within it
+        double score() const { return win - loss; }
+    };
+
+    // Where a solve starts; mirrors Game::DecisionKind, plus Turn for
+    // the start of a turn (before the chain bonus and reinforcements).
+    enum class Stage { Turn, Reinforce, Attack, Move, Fortify };
+
+    struct Spot {
+        Stage stage{Stage::Turn};
+        PlayerId player{PlayerId::P1};
+        int amount{0};                   // Reinforce: armies to place; Move: most that may move
+        TerrId from{-1}, to{-1};         // Move: the capture being filled
+    };
+
+    struct Choice {                      // best answer at a Spot; mirrors Game::Action
+        bool pass{false};                // Attack: stop; Fortify: skip
+        TerrId from{-1}, to{-1};         // Reinforce uses `to`
+        int amount{0};                   // Move / Fortify
+    };
+
+    struct Config {
+        int horizon{2};                  // turns of both sides, the current one included
+        std::size_t nodeBudget{50000};   // expansions per solve (0 = unlimited)
+        bool blitz{false};               // attacks fight to the end (Game::setBlitz)
+        int maxMinority{2};              // inRange: territories of the smaller side
+        int maxContested{60};            // inRange: its armies + the enemy's bordering it
+    };
+
+    // Key of a map's adjacency, so a table is only used on its own map.
+    std::uint64_t topologyKey(const MapTopology& m);
+
+    // ---------- Offline table ----------
+    class Table {
+    public:
+        static constexpr int kMaxTerritories = 8;
+
+        Table() = default;
+        ~Table();
+        Table(const Table&) = delete;
+        Table& operator=(const Table&) = delete;
+
+        bool open(const std::string& path);     // mmap; false if not a table
+        void close();
+
+        int territories() const { return territories_; }
+        int maxArmies() const { return maxArmies_; }
+        int horizon() const { return horizon_; }
+        bool blitz() const { return blitz_; }
+        std::uint64_t mapKey() const { return mapKey_; }
+
+        // Value at the start of `p`'s turn with `turnsLeft` turns to go;
+        // false when the position is not covered.
+        bool lookup(const Board& b, PlayerId p, int turnsLeft, Value& out) const;
+
+        // Solves every covered position (layer by layer, so each one
+        // reuses the last) and writes the table. Returns positions solved.
+        static std::size_t build(const std::shared_ptr<const MapTopology>& map, int maxArmies,
+                                 const Config& cfg, const std::string& path);
+
+    private:
+        const std::uint8_t* data_{nullptr};
+        std::size_t size_{0};
+        int territories_{0};
+        int maxArmies_{0};
+        int horizon_{0};
+        bool blitz_{false};
+        std::uint64_t mapKey_{0};
+        bool mapped_{false};                    // data_ is ours to munmap
+    };
+
+    // ---------- Solver ----------
+    // One per thread: it owns a working Board and the memo.
+    class Solver {
+    public:
+        explicit Solver(Config cfg = {});
+
+        const Config& config() const { return cfg_; }
+        void setTable(const Table* t);            // not owned; nullptr = none
+
+        // Cheap filter before a search: small boards, or one side down
+        // to a few territories, with few armies in play around them.
+        // Armies away from the fight do not count, so the filter still
+        // passes on a big map once reinforcements pile up elsewhere.
+        bool inRange(const Board& b) const;
+
+        // Value at `at` for at.player, and the best choice there (not
+        // for Stage::Turn). false = over the node budget, nothing known.
+        bool solve(const Board& b, const Spot& at, Value& value, Choice* best = nullptr);
+
+        std::size_t nodes() const { return nodes_; }   // expanded by the last solve
+        std::size_t memoSize() const { return memo_.size(); }
+        void clear();
+
+    private:
+        Value turnStart(PlayerId p, int left);
+        Value reinforce(PlayerId p, int amount, int left, Choice* best);
+        Value attack(PlayerId p, int left, Choice* best);
+        Value battle(PlayerId p, TerrId from, TerrId to, int left);
+        Value move(PlayerId p, TerrId from, TerrId to, int left, Choice* best);
+        Value fortify(PlayerId p, int left, Choice* best);
+
+        bool quiet(PlayerId p, int left) const;   // nothing after this turn matters
+        bool settled(PlayerId p, int left) const; // ... and p cannot win this turn
+        bool expand();                            // false once over budget
+        std::uint64_t key(PlayerId p, Stage s, int left, int amount = 0,
+                          TerrId from = 0, TerrId to = 0) const;
+        bool recall(std::uint64_t k, Value& v) const;
+        void remember(std::uint64_t k, const Value& v);
+
+        Config cfg_;
+        const Table* table_{nullptr};
+        bool tableFits_{false};                   // table_ is for board_'s map
+        Board board_;
+        std::shared_ptr<const MapTopology> map_;  // memo_ belongs to this map
+        std::unordered_map<std::uint64_t, Value> memo_;
+        std::size_t nodes_{0};
+        bool aborted_{false};
+    };
+
+} // namespace Endgame
+
+// ---------- Controller: perfect play in range, another AI elsewhere ----------
+// After a solve runs over budget, the rest of that turn goes to the
+// fallback without trying again.
+class EndgameController : public Controller {
+public:
+    EndgameController(std::unique_ptr<Controller> fallback, Endgame::Config cfg = {},
+                      const Endgame::Table* table = nullptr);
+
+    TerrId chooseReinforcement(const Board& b, PlayerId p, int reinforcements) override;
+    bool chooseAttack(const Board& b, PlayerId p, int attacksSoFar,
+                      IO::AttackChoice& out) override;
+    int chooseMoveAfterCapture(const Board& b, TerrId from, TerrId to, int maxMove) override;
+    bool chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) override;
+
+private:
+    bool solved(const Board& b, const Endgame::Spot& at, Endgame::Choice& c);
+
+    std::unique_ptr<Controller> fallback_;
+    Endgame::Solver solver_;
+    bool gaveUp_{false};                  // this turn
+};
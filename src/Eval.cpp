@@ -0,0 +1,105 @@
+#include "Eval.h"
+#include "Playout.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int kPairsPerTask = 8;     // rollout pairs per parallelFor index
+
+// One rollout turn's dice. The antithetic twin flips every draw, so
+// each round's outcome goes from one end of Dice's cut points to the
+// other.
+struct TurnDice {
+    Rng::Stream rng;
+    std::uint32_t flip;
+    std::uint32_t next32() { return rng.next32() ^ flip; }
+};
+
+// Working boards, one pair per thread and reused by every task and
+// call: assigning a position into them keeps their buffers, so once
+// warm a rollout never allocates.
+thread_local Board tStart, tWork;
+
+// Half points for `toMove`: 2 = win, 1 = draw, 0 = loss. Turn t rolls
+// from stream.split(t), so a long battle in one turn does not shift
+// the dice of the next.
+int rollout(Board& b, PlayerId toMove, const Rng::Stream& stream, bool flip, int maxTurns) {
+    PlayerId p = toMove;
+    for (int t = 0; t < maxTurns && b.status() == GameState::Ongoing; ++t) {
+        TurnDice dice{stream.split(static_cast<std::uint64_t>(t)), flip ? ~0u : 0u};
+        Playout::greedyTurn(b, p, dice);
+        p = other(p);
+    }
+    switch (b.status()) {
+        case GameState::Player1Wins: return toMove == PlayerId::P1 ? 2 : 0;
+        case GameState::Player2Wins: return toMove == PlayerId::P2 ? 2 : 0;
+        default:                     return 1;
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+namespace Eval {
+
+Estimate evaluate(const Board& b, PlayerId toMove, const Config& cfg) {
+    return evaluate(std::vector<Position>{{&b, toMove}}, cfg).front();
+}
+
+std::vector<Estimate> evaluate(const std::vector<Position>& positions, const Config& cfg) {
+    const std::size_t pairs = static_cast<std::size_t>(std::max(1, (cfg.samples + 1) / 2));
+    const std::size_t tasksPer = (pairs + kPairsPerTask - 1) / kPairsPerTask;
+    std::vector<std::uint8_t> points(positions.size() * pairs * 2);
+    const Rng::Stream master(cfg.seed);
+
+    auto task = [&](std::size_t i) {
+        const std::size_t pos = i / tasksPer;
+        const std::size_t first = (i % tasksPer) * kPairsPerTask;
+        const std::size_t last = std::min(pairs, first + kPairsPerTask);
+        Board& start = tStart;
+        Board& work = tWork;
+        start = *positions[pos].board;
+        start.endRecording();                 // rollouts need no undo log
+        for (std::size_t j = first; j < last; ++j)
+            for (int twin = 0; twin < 2; ++twin) {
+                const Rng::Stream stream = master.split(cfg.antithetic ? 2 * j : 2 * j + twin);
+                work = start;
+                points[(pos * pairs + j) * 2 + twin] = static_cast<std::uint8_t>(
+                    rollout(work, positions[pos].toMove, stream, cfg.antithetic && twin, cfg.maxTurns));
+            }
+    };
+    const std::size_t tasks = positions.size() * tasksPer;
+    if (cfg.pool) cfg.pool->parallelFor(tasks, task);
+    else for (std::size_t i = 0; i < tasks; ++i) task(i);
+
+    // Pair means in pair order, so the sums do not depend on scheduling.
+    std::vector<Estimate> out(positions.size());
+    for (std::size_t pos = 0; pos < positions.size(); ++pos) {
+        int counts[3] = {0, 0, 0};
+        double sum = 0.0, sumSq = 0.0;
+        for (std::size_t j = 0; j < pairs; ++j) {
+            const int a = points[(pos * pairs + j) * 2], b = points[(pos * pairs + j) * 2 + 1];
+            ++counts[a];
+            ++counts[b];
+            const double y = (a + b) / 4.0;
+            sum += y;
+            sumSq += y * y;
+        }
+        Estimate& e = out[pos];
+        const double n = static_cast<double>(2 * pairs), m = static_cast<double>(pairs);
+        e.samples = static_cast<int>(2 * pairs);
+        e.win = counts[2] / n;
+        e.draw = counts[1] / n;
+        e.loss = counts[0] / n;
+        e.score = sum / m;
+        const double var = pairs > 1 ? std::max(0.0, (sumSq - sum * sum / m) / (m - 1)) : 0.25;
+        e.halfWidth = cfg.z * std::sqrt(var / m);
+    }
+    return out;
+}
+
+} // namespace Eval
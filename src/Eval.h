@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+#include "Types.h"
+
+class ThreadPool;
+
+// ------------------------------------------------------------
+// Eval — who is winning from this Board?
+// ------------------------------------------------------------
+// Plays `samples` headless rollouts from the position and counts
+// wins, draws and losses for the side to move. Each rollout turn
+// is Playout::greedyTurn, the MCTS playout policy (reinforce the
+// strongest frontier territory, attack while the exact capture odds
+// are at least 50%, move everything in), so the dice are its only
+// randomness.
+// The dice come from one uniform per round (Dice::attackerLosses),
+// and two tricks reduce variance:
+//  • Antithetic pairs: rollout 2j rolls u and rollout 2j+1 rolls
+//    ~u, so a lucky roll in one is an unlucky roll in the other.
+//  • Common random numbers: rollout j's dice depend only on
+//    (seed, j, turn), never on the position. Two positions scored
+//    with one seed see the same dice, so their difference is much
+//    less noisy than either estimate (compare moves this way).
+// Pair means are i.i.d., so the interval is mean ± z·sd/√pairs over
+// them. A rollout still going after `maxTurns` counts as a draw.
+// Results depend only on (position, Config), never on the thread
+// count.
+//
+namespace Eval {
+
+    struct Config {
+        int samples{128};                // rollouts (rounded up to whole pairs)
+        int maxTurns{60};                // per rollout, then a draw
+        std::uint64_t seed{1};           // dice; same seed = common random numbers
+        bool antithetic{true};           // false = independent pairs
+        double z{1.96};                  // interval width (1.96 = 95%)
+        ThreadPool* pool{nullptr};       // runs the rollouts (nullptr = caller)
+    };
+
+    struct Estimate {
+        double win{0.0}, draw{0.0}, loss{0.0};   // for the side to move
+        double score{0.5};               // win + draw / 2
+        double halfWidth{0.5};           // score's interval is score ± halfWidth
+        int samples{0};
+
+        double low() const { return score - halfWidth; }
+        double high() const { return score + halfWidth; }
+    };
+
+    Estimate evaluate(const Board& b, PlayerId toMove, const Config& cfg = {});
+
+    // Many positions at once, all rollouts spread over cfg.pool.
+    struct Position {
+        const Board* board;
+        PlayerId toMove;
+    };
+    std::vector<Estimate> evaluate(const std::vector<Position>& positions, const Config& cfg = {});
+
+} // namespace Eval
@@ -0,0 +1,298 @@
+#include "GameRecord.h"
+#include "MapSpec.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr char kMagic[4] = {'M', 'R', 'G', 'R'};
+    constexpr char kTrailerMagic[4] = {'M', 'R', 'G', 'X'};
+    constexpr std::size_t kTrailerSize = 24;
+    constexpr std::size_t kSpillBytes = 1 << 16;
+
+    std::uint64_t readFixed(const std::uint8_t* p, int bytes) {
+        std::uint64_t v = 0;
+        for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+        return v;
+    }
+}
+
+// ============================================================
+// GameRecorder
+// ============================================================
+GameRecorder::GameRecorder(const std::string& path, int keyframeInterval)
+    : file_(std::fopen(path.c_str(), "wb")), interval_(std::max(1, keyframeInterval)) {
+    buf_.reserve(kSpillBytes + 1024);
+}
+
+GameRecorder::~GameRecorder() {
+    if (file_) std::fclose(file_);       // unfinished: header and events only
+}
+
+void GameRecorder::putVar(std::uint64_t v) {
+    while (v >= 0x80) {
+        put(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    put(static_cast<std::uint8_t>(v));
+}
+
+void GameRecorder::putFixed(std::uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) put(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+void GameRecorder::spill(bool force) {
+    if (!file_ || buf_.empty() || (!force && buf_.size() < kSpillBytes)) return;
+    if (std::fwrite(buf_.data(), 1, buf_.size(), file_) != buf_.size()) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    written_ += buf_.size();
+    buf_.clear();
+}
+
+// ---------- Events ----------
+void GameRecorder::begin(std::uint32_t mapSeed, const Board& b) {
+    buf_.insert(buf_.end(), kMagic, kMagic + 4);
+    putVar(GameRecord::kVersion);
+    putVar(mapSeed);
+    putVar(static_cast<std::uint64_t>(b.count()));
+    putVar(static_cast<std::uint64_t>(interval_));
+}
+
+void GameRecorder::turn(int turn, PlayerId p, const Board& b) {
+    if ((turn - 1) % interval_ == 0) {
+        keyframes_.push_back(written_ + buf_.size());
+        put(GameRecord::kKeyframe);
+        putVar(static_cast<std::uint64_t>(turn));
+        for (int i = 0; i < b.count(); ++i) {
+            put(static_cast<std::uint8_t>(static_cast<int>(b.owner(i)) + 1));
+            putVar(static_cast<std::uint64_t>(std::max(0, b.armies(i))));
+        }
+    }
+    put(GameRecord::kTurn);
+    putVar(static_cast<std::uint64_t>(turn));
+    put(static_cast<std::uint8_t>(p));
+    spill(false);
+}
+
+void GameRecorder::reinforce(TerrId id, int amount) {
+    put(GameRecord::kReinforce);
+    putVar(static_cast<std::uint64_t>(id));
+    putVar(static_cast<std::uint64_t>(amount));
+}
+
+void GameRecorder::battle(TerrId from, TerrId to, int attackerLoss, int defenderLoss) {
+    put(GameRecord::kBattle);
+    putVar(static_cast<std::uint64_t>(from));
+    putVar(static_cast<std::uint64_t>(to));
+    put(static_cast<std::uint8_t>(attackerLoss * 4 + defenderLoss));
+}
+
+void GameRecorder::blitz(TerrId from, TerrId to, int attackerLoss, int defenderLoss) {
+    put(GameRecord::kBlitz);
+    putVar(static_cast<std::uint64_t>(from));
+    putVar(static_cast<std::uint64_t>(to));
+    putVar(static_cast<std::uint64_t>(attackerLoss));
+    putVar(static_cast<std::uint64_t>(defenderLoss));
+}
+
+void GameRecorder::captureMove(TerrId from, TerrId to, int amount) {
+    put(GameRecord::kCaptureMove);
+    putVar(static_cast<std::uint64_t>(from));
+    putVar(static_cast<std::uint64_t>(to));
+    putVar(static_cast<std::uint64_t>(amount));
+}
+
+void GameRecorder::fortify(TerrId from, TerrId to, int amount) {
+    put(GameRecord::kFortify);
+    putVar(static_cast<std::uint64_t>(from));
+    putVar(static_cast<std::uint64_t>(to));
+    putVar(static_cast<std::uint64_t>(amount));
+}
+
+void GameRecorder::finish(GameState status, int turns) {
+    put(GameRecord::kEnd);
+    put(static_cast<std::uint8_t>(status));
+    putVar(static_cast<std::uint64_t>(turns));
+
+    const std::uint64_t indexOffset = written_ + buf_.size();
+    for (std::uint64_t off : keyframes_) putFixed(off, 8);
+    putFixed(indexOffset, 8);
+    putFixed(keyframes_.size(), 4);
+    putFixed(static_cast<std::uint64_t>(turns), 4);
+    put(static_cast<std::uint8_t>(status));
+    putFixed(0, 3);
+    buf_.insert(buf_.end(), kTrailerMagic, kTrailerMagic + 4);
+
+    spill(true);
+    if (file_) std::fclose(file_);
+    file_ = nullptr;
+}
+
+// ============================================================
+// GameReader
+// ============================================================
+struct GameReader::Cursor {
+    const std::uint8_t* p;
+    const std::uint8_t* end;
+
+    bool byte(std::uint8_t& out) {
+        if (p >= end) return false;
+        out = *p++;
+        return true;
+    }
+    bool var(std::uint64_t& out) {
+        out = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) return false;
+            std::uint8_t b = *p++;
+            out |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+    bool id(int n, TerrId& out) {
+        std::uint64_t v;
+        if (!var(v) || v >= static_cast<std::uint64_t>(n)) return false;
+        out = static_cast<TerrId>(v);
+        return true;
+    }
+};
+
+GameReader::~GameReader() { close(); }
+
+void GameReader::close() {
+    if (data_) munmap(const_cast<std::uint8_t*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool GameReader::open(const std::string& path, std::shared_ptr<const MapTopology> map) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < kTrailerSize + 4) {
+        ::close(fd);
+        return false;
+    }
+    void* m = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (m == MAP_FAILED) return false;
+    data_ = static_cast<const std::uint8_t*>(m);
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    // Trailer
+    const std::uint8_t* t = data_ + size_ - kTrailerSize;
+    if (std::memcmp(data_, kMagic, 4) != 0 || std::memcmp(t + 20, kTrailerMagic, 4) != 0) {
+        close();
+        return false;
+    }
+    indexOffset_ = readFixed(t, 8);
+    keyframeCount_ = static_cast<std::uint32_t>(readFixed(t + 8, 4));
+    turns_ = static_cast<int>(readFixed(t + 12, 4));
+    status_ = static_cast<GameState>(t[16]);
+    if (indexOffset_ + 8ull * keyframeCount_ + kTrailerSize != size_) { close(); return false; }
+
+    // Header
+    Cursor c{data_ + 4, data_ + indexOffset_};
+    std::uint64_t version, seed, n, interval;
+    if (!c.var(version) || version != GameRecord::kVersion ||
+        !c.var(seed) || !c.var(n) || !c.var(interval) || interval == 0) {
+        close();
+        return false;
+    }
+    mapSeed_ = static_cast<std::uint32_t>(seed);
+    territories_ = static_cast<int>(n);
+    interval_ = static_cast<int>(interval);
+
+    if (!map) {
+        const unsigned s = mapSeed_;
+        map = MapTopology::make(territories_ == MapSpec::kDefaultTerritories
+                                    ? MapSpec::build20(s)
+                                    : MapSpec::build(territories_, s));
+    }
+    if (map->count() != territories_) { close(); return false; }
+    map_ = std::move(map);
+    return true;
+}
+
+bool GameReader::loadKeyframe(Cursor& c, Board& out) const {
+    std::uint8_t tag;
+    std::uint64_t turn;
+    if (!c.byte(tag) || tag != GameRecord::kKeyframe || !c.var(turn)) return false;
+    Board::Snapshot s;
+    s.owner.resize(territories_);
+    s.armies.resize(territories_);
+    for (int i = 0; i < territories_; ++i) {
+        std::uint8_t o;
+        std::uint64_t a;
+        if (!c.byte(o) || o > 2 || !c.var(a)) return false;
+        s.owner[i] = static_cast<std::int8_t>(o - 1);
+        s.armies[i] = static_cast<int>(a);
+    }
+    if (out.count() != territories_ || out.sharedTopology() != map_) out = Board(map_);
+    out.restore(s);
+    return true;
+}
+
+bool GameReader::seek(int turn, Board& out, PlayerId& toMove) const {
+    if (!data_ || turn < 1 || turn > turns_) return false;
+    const std::uint32_t k = static_cast<std::uint32_t>((turn - 1) / interval_);
+    if (k >= keyframeCount_) return false;
+
+    const std::uint64_t off = readFixed(data_ + indexOffset_ + 8ull * k, 8);
+    Cursor c{data_ + off, data_ + indexOffset_};
+    if (!loadKeyframe(c, out)) return false;
+
+    // Replay up to the requested turn's Turn event.
+    const int n = territories_;
+    for (;;) {
+        std::uint8_t tag;
+        if (!c.byte(tag)) return false;
+        TerrId a = -1, b = -1;
+        std::uint64_t v = 0;
+        switch (tag) {
+            case GameRecord::kTurn: {
+                std::uint8_t p;
+                if (!c.var(v) || !c.byte(p)) return false;
+                if (static_cast<int>(v) == turn) {
+                    toMove = static_cast<PlayerId>(p);
+                    return true;
+                }
+                break;
+            }
+            case GameRecord::kKeyframe:
+                return false;              // passed the target without seeing it
+            case GameRecord::kReinforce:
+                if (!c.id(n, a) || !c.var(v)) return false;
+                out.addArmies(a, static_cast<int>(v));
+                break;
+            case GameRecord::kBattle: {
+                std::uint8_t loss;
+                if (!c.id(n, a) || !c.id(n, b) || !c.byte(loss)) return false;
+                const PlayerId attacker = out.owner(a);
+                if (out.applyLosses(a, b, loss >> 2, loss & 3)) out.capture(b, attacker);
+                break;
+            }
+            case GameRecord::kBlitz: {
+                std::uint64_t dl;
+                if (!c.id(n, a) || !c.id(n, b) || !c.var(v) || !c.var(dl)) return false;
+                const PlayerId attacker = out.owner(a);
+                if (out.applyLosses(a, b, static_cast<int>(v), static_cast<int>(dl))) out.capture(b, attacker);
+                break;
+            }
+            case GameRecord::kCaptureMove:
+            case GameRecord::kFortify:
+                if (!c.id(n, a) || !c.id(n, b) || !c.var(v)) return false;
+                out.moveArmies(a, b, static_cast<int>(v));
+                break;
+            default:                        // kEnd or corrupt
+                return false;
+        }
+    }
+}
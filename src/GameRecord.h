@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "MapTopology.h"
+#include "Types.h"
+
+// ------------------------------------------------------------
+// GameRecord — compact binary log of one game
+// ------------------------------------------------------------
+// Layout (all integers LEB128 varints unless noted):
+//   header   "MRGR" version mapSeed territories keyframeInterval
+//   events   tag byte + fields:
+//              Keyframe   turn, then owner byte + armies per territory
+//              Turn       turn, player
+//              Reinforce  territory, amount      (bonus and base)
+//              Battle     from, to, losses byte  (attacker*4 + defender;
+//                                                 a capture is implied when
+//                                                 the defender reaches 0)
+//              CaptureMove / Fortify  from, to, amount
+//              Blitz      from, to, attacker losses, defender losses
+//                                                (a whole battle, Rules::applyBlitz)
+//              End        status, turns
+//   index    fixed u64 (little-endian) offset of every keyframe
+//   trailer  u64 index offset, u32 keyframes, u32 turns, u8 status,
+//            3 pad bytes, "MRGX"                      (24 bytes)
+// A keyframe precedes turn 1 (the deal) and every `interval`-th
+// turn after it, so the reader seeks to a turn with one index
+// lookup plus at most `interval` turns of replay.
+//
+namespace GameRecord {
+
+    constexpr std::uint32_t kVersion = 1;
+    constexpr int kDefaultKeyframeInterval = 16;
+
+    enum Tag : std::uint8_t {
+        kKeyframe = 1, kTurn, kReinforce, kBattle, kCaptureMove, kFortify, kEnd, kBlitz
+    };
+
+} // namespace GameRecord
+
+// ---------- Writer ----------
+class GameRecorder {
+public:
+    explicit GameRecorder(const std::string& path,
+                          int keyframeInterval = GameRecord::kDefaultKeyframeInterval);
+    ~GameRecorder();
+
+    GameRecorder(const GameRecorder&) = delete;
+    GameRecorder& operator=(const GameRecorder&) = delete;
+
+    bool ok() const { return file_ != nullptr; }
+
+    // Called by Game::play, in this order.
+    void begin(std::uint32_t mapSeed, const Board& b);
+    void turn(int turn, PlayerId p, const Board& b);    // keyframe when due
+    void reinforce(TerrId id, int amount);
+    void battle(TerrId from, TerrId to, int attackerLoss, int defenderLoss);
+    void blitz(TerrId from, TerrId to, int attackerLoss, int defenderLoss);
+    void captureMove(TerrId from, TerrId to, int amount);
+    void fortify(TerrId from, TerrId to, int amount);
+    void finish(GameState status, int turns);           // writes index + trailer, closes
+
+private:
+    void put(std::uint8_t byte) { buf_.push_back(byte); }
+    void putVar(std::uint64_t v);
+    void putFixed(std::uint64_t v, int bytes);
+    void spill(bool force);
+
+    std::FILE* file_{nullptr};
+    std::vector<std::uint8_t> buf_;
+    std::uint64_t written_{0};          // bytes already in the file
+    int interval_;
+    std::vector<std::uint64_t> keyframes_;
+};
+
+// ---------- Reader ----------
+class GameReader {
+public:
+    GameReader() = default;
+    ~GameReader();
+
+    GameReader(const GameReader&) = delete;
+    GameReader& operator=(const GameReader&) = delete;
+
+    // Maps the file and checks header and trailer. `map` is the game's
+    // topology; when null it is regenerated from the recorded map seed.
+    bool open(const std::string& path, std::shared_ptr<const MapTopology> map = nullptr);
+    void close();
+
+    std::uint32_t mapSeed() const { return mapSeed_; }
+    int territories() const { return territories_; }
+    int turns() const { return turns_; }
+    GameState result() const { return status_; }
+    int keyframeInterval() const { return interval_; }
+    int keyframeCount() const { return static_cast<int>(keyframeCount_); }
+
+    // Board at the start of `turn` (1 … turns()) and the side to move.
+    bool seek(int turn, Board& out, PlayerId& toMove) const;
+
+private:
+    struct Cursor;
+    bool loadKeyframe(Cursor& c, Board& out) const;
+
+    const std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+    std::shared_ptr<const MapTopology> map_;
+    std::uint32_t mapSeed_{0};
+    int territories_{0};
+    int interval_{0};
+    int turns_{0};
+    GameState status_{GameState::Ongoing};
+    std::uint64_t indexOffset_{0};
+    std::uint32_t keyframeCount_{0};
+};
@@ -1,4 +1,5 @@
 #include "IO.h"
+#include "Renderer.h"
 #include "Rules.h"
 #include <algorithm>
 #include <cctype>
@@ -28,7 +29,7 @@ namespace {
     TerrId findByCode(const Board& b, char code) {
         char up = toUpper(code);
         for (int i = 0; i < b.count(); ++i)
-            if (toUpper(b.at(i).code) == up)
+            if (toUpper(b.code(i)) == up)
                 return i;
         return -1;
     }
@@ -40,7 +41,10 @@ void IO::printBoard(const Board& b, bool showOwner, bool showArmies, int cellWid
 }
 
 void IO::printBoardColor(const Board& b, int cellWidth) {
-    std::cout << b.renderColor(cellWidth) << std::flush;
+    static BoardRenderer renderer(cellWidth);
+    if (renderer.cellWidth() != std::max(2, cellWidth)) renderer = BoardRenderer(cellWidth);
+    std::cout.flush();                               // keep ordering with earlier text
+    BoardRenderer::present(renderer.frame(b));
 }
 
 void IO::println(const std::string& s) {
@@ -114,7 +118,7 @@ TerrId IO::readTerritoryByCode(const Board& b, const std::string& prompt) {
 TerrId IO::readOwnedTerritory(const Board& b, PlayerId p, const std::string& prompt) {
     while (true) {
         TerrId id = readTerritoryByCode(b, prompt);
-        if (b.at(id).owner == p) return id;
+        if (b.owner(id) == p) return id;
         std::cout << "You do not own that territory. Try again.\n";
     }
 }
@@ -125,7 +129,7 @@ IO::AttackChoice IO::readAttackChoice(const Board& b, PlayerId attacker,
                                       const std::string& toPrompt) {
     while (true) {
         TerrId from = readOwnedTerritory(b, attacker, fromPrompt);
-        if (b.at(from).armies < 2) {
+        if (b.armies(from) < 2) {
             std::cout << "You must have at least 2 armies to attack.\n";
             continue;
         }
@@ -136,7 +140,7 @@ IO::AttackChoice IO::readAttackChoice(const Board& b, PlayerId attacker,
             continue;
         }
 
-        if (b.at(to).owner == attacker || b.at(to).owner == PlayerId::None) {
+        if (b.owner(to) == attacker || b.owner(to) == PlayerId::None) {
             std::cout << "You can only attack enemy-held territories.\n";
             continue;
         }
@@ -163,7 +167,7 @@ IO::FortifyChoice IO::readFortifyChoice(const Board& b, PlayerId p,
             continue;
         }
 
-        int maxMove = std::max(0, b.at(from).armies - 1);
+        int maxMove = std::max(0, b.armies(from) - 1);
         if (maxMove <= 0) {
             std::cout << "Not enough armies to move (must leave 1 behind).\n";
             continue;
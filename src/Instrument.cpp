@@ -0,0 +1,249 @@
+#include "Instrument.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+namespace Instrument {
+
+namespace {
+    std::atomic<detail::ThreadBlock*> gBlocks{nullptr};   // every block, never freed (see free)
+    std::atomic<bool> gDumpAtGameEnd{false};
+
+    std::uint64_t steadyNs() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Tick rate from the span since start-up (at least 1 ms of it).
+    const std::uint64_t gStartTicks = detail::ticks();
+    const std::uint64_t gStartNs = steadyNs();
+
+    double nsPerTick() {
+        std::uint64_t ns = steadyNs();
+        while (ns - gStartNs < 1000000) ns = steadyNs();
+        const std::uint64_t t = detail::ticks();
+        return t > gStartTicks ? static_cast<double>(ns - gStartNs) / (t - gStartTicks) : 1.0;
+    }
+
+    constexpr std::memory_order kRelaxed = std::memory_order_relaxed;
+}
+
+namespace detail {
+namespace {
+    // Hands the thread's block back when the thread exits. A thread
+    // that records again after that (from a later thread_local
+    // destructor) keeps the block it then takes.
+    struct Owner {
+        ThreadBlock* block{nullptr};
+        ~Owner() {
+            if (!block) return;
+            tls = nullptr;
+            exiting = true;
+            block->free.store(true, std::memory_order_release);
+        }
+        static inline thread_local bool exiting = false;
+    };
+    thread_local Owner tOwner;
+}
+
+    // A block left by an exited thread, else a new one: calloc +
+    // placement new, since operator new counts into this block and
+    // creating it must not go through operator new.
+    ThreadBlock* registerThread() {
+        ThreadBlock* b = nullptr;
+        for (auto* c = gBlocks.load(std::memory_order_acquire); c && !b; c = c->next) {
+            bool was = true;
+            if (c->free.load(kRelaxed) &&
+                c->free.compare_exchange_strong(was, false, std::memory_order_acquire, kRelaxed))
+                b = c;
+        }
+        if (!b) {
+            void* mem = std::calloc(1, sizeof(ThreadBlock));
+            if (!mem) std::abort();
+            b = new (mem) ThreadBlock();
+            b->next = gBlocks.load(kRelaxed);
+            while (!gBlocks.compare_exchange_weak(b->next, b, std::memory_order_release, kRelaxed)) {}
+        }
+        tls = b;
+        if (!Owner::exiting) tOwner.block = b;
+        return b;
+    }
+} // namespace detail
+
+// ---------- Names ----------
+const char* name(Counter c) {
+    static const char* kNames[kCounterCount] = {
+        "battles", "dice rounds", "captures", "rules queries", "endgame nodes", "allocations", "alloc bytes"};
+    return kNames[c];
+}
+
+const char* name(Phase p) {
+    static const char* kNames[kPhaseCount] = {"reinforce", "attack", "fortify"};
+    return kNames[p];
+}
+
+const char* name(Decision d) {
+    static const char* kNames[kDecisionCount] = {
+        "chooseReinforcement", "chooseAttack", "chooseFortify"};
+    return kNames[d];
+}
+
+// ---------- Histogram ----------
+// Values below 2·kSub map to themselves; above that each power of
+// two [2^e, 2^(e+1)) splits into kSub equal buckets.
+int Histogram::bucketOf(std::uint64_t v) {
+    if (v < 2 * kSub) return static_cast<int>(v);
+    const int e = 63 - __builtin_clzll(v);
+    return (e - kSubBits + 1) * kSub + static_cast<int>((v >> (e - kSubBits)) & (kSub - 1));
+}
+
+std::uint64_t Histogram::lowerBound(int bucket) {
+    if (bucket < 2 * kSub) return static_cast<std::uint64_t>(bucket);
+    const int e = bucket / kSub + kSubBits - 1;
+    return static_cast<std::uint64_t>(kSub + bucket % kSub) << (e - kSubBits);
+}
+
+void Histogram::record(std::uint64_t v) {
+    ++buckets[bucketOf(v)];
+    ++count;
+    sum += v;
+    max = std::max(max, v);
+}
+
+std::uint64_t Histogram::percentile(double q) const {
+    if (count == 0) return 0;
+    q = std::min(1.0, std::max(0.0, q));
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(q * count + 0.5));
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen < rank) continue;
+        const std::uint64_t lo = lowerBound(i);
+        const std::uint64_t hi = i + 1 < kBuckets ? lowerBound(i + 1) : lo;
+        return std::min(max, lo + (hi - lo) / 2);
+    }
+    return max;
+}
+
+// ---------- Recording ----------
+void enterPhase(Phase p) {
+    detail::bump(detail::block().phaseTurns[p], 1);
+}
+
+void addPhase(Phase p, std::uint64_t ticks) {
+    detail::bump(detail::block().phaseTicks[p], ticks);
+}
+
+void addDecision(Decision d, std::uint64_t ticks) {
+    detail::ThreadBlock& b = detail::block();
+    detail::bump(b.decisions[d][Histogram::bucketOf(ticks)], 1);
+    detail::bump(b.decisionSum[d], ticks);
+    if (ticks > b.decisionMax[d].load(kRelaxed)) b.decisionMax[d].store(ticks, kRelaxed);
+}
+
+// ---------- Reporting ----------
+Report snapshot() {
+    Report r;
+    const double scale = nsPerTick();
+    auto toNs = [scale](std::uint64_t t) { return static_cast<std::uint64_t>(t * scale + 0.5); };
+    for (auto* b = gBlocks.load(std::memory_order_acquire); b; b = b->next) {
+        for (int c = 0; c < kCounterCount; ++c) r.counters[c] += b->counters[c].load(kRelaxed);
+        for (int p = 0; p < kPhaseCount; ++p) {
+            r.phaseNs[p] += toNs(b->phaseTicks[p].load(kRelaxed));
+            r.phaseTurns[p] += b->phaseTurns[p].load(kRelaxed);
+        }
+        // Re-bucket each tick bucket's midpoint on the nanosecond scale.
+        for (int d = 0; d < kDecisionCount; ++d) {
+            Histogram& h = r.decisions[d];
+            for (int i = 0; i < Histogram::kBuckets; ++i) {
+                const std::uint64_t n = b->decisions[d][i].load(kRelaxed);
+                if (n == 0) continue;
+                const std::uint64_t lo = Histogram::lowerBound(i);
+                const std::uint64_t hi = i + 1 < Histogram::kBuckets ? Histogram::lowerBound(i + 1) : lo;
+                h.buckets[Histogram::bucketOf(toNs(lo + (hi - lo) / 2))] += n;
+                h.count += n;
+            }
+            h.sum += toNs(b->decisionSum[d].load(kRelaxed));
+            h.max = std::max(h.max, toNs(b->decisionMax[d].load(kRelaxed)));
+        }
+    }
+    return r;
+}
+
+std::uint64_t total(Counter c) {
+    std::uint64_t sum = 0;
+    for (auto* b = gBlocks.load(std::memory_order_acquire); b; b = b->next)
+        sum += b->counters[c].load(kRelaxed);
+    return sum;
+}
+
+void reset() {
+    for (auto* b = gBlocks.load(std::memory_order_acquire); b; b = b->next) {
+        for (auto& c : b->counters) c.store(0, kRelaxed);
+        for (auto& c : b->phaseTicks) c.store(0, kRelaxed);
+        for (auto& c : b->phaseTurns) c.store(0, kRelaxed);
+        for (auto& c : b->decisionSum) c.store(0, kRelaxed);
+        for (auto& c : b->decisionMax) c.store(0, kRelaxed);
+        for (auto& h : b->decisions)
+            for (auto& c : h) c.store(0, kRelaxed);
+    }
+}
+
+void dump(std::ostream& os) {
+    dump(os, snapshot());
+}
+
+void dump(std::ostream& os, const Report& r) {
+    const auto flags = os.flags();
+    const auto prec = os.precision();
+    os << "=== Instrumentation ===\n";
+    if (!kEnabled) os << "(compiled out: MINIRISK_INSTRUMENT=0)\n";
+
+    os << "Counters:\n";
+    for (int c = 0; c < kCounterCount; ++c)
+        os << "  " << std::left << std::setw(22) << name(static_cast<Counter>(c))
+           << std::right << std::setw(14) << r.counters[c] << "\n";
+
+    os << std::fixed << std::setprecision(2)
+       << "Phases:" << std::setw(23) << "turns" << std::setw(14) << "total ms"
+       << std::setw(12) << "mean us" << "\n";
+    for (int p = 0; p < kPhaseCount; ++p) {
+        const double ms = r.phaseNs[p] / 1e6;
+        const double mean = r.phaseTurns[p] ? r.phaseNs[p] / 1e3 / r.phaseTurns[p] : 0.0;
+        os << "  " << std::left << std::setw(22) << name(static_cast<Phase>(p)) << std::right
+           << std::setw(8) << r.phaseTurns[p] << std::setw(14) << ms << std::setw(12) << mean << "\n";
+    }
+
+    os << "Decisions (us):" << std::setw(15) << "calls" << std::setw(10) << "mean"
+       << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+       << std::setw(10) << "max" << "\n";
+    for (int d = 0; d < kDecisionCount; ++d) {
+        const Histogram& h = r.decisions[d];
+        os << "  " << std::left << std::setw(22) << name(static_cast<Decision>(d)) << std::right
+           << std::setw(8) << h.count << std::setw(10) << h.mean() / 1e3
+           << std::setw(10) << h.percentile(0.50) / 1e3 << std::setw(10) << h.percentile(0.90) / 1e3
+           << std::setw(10) << h.percentile(0.99) / 1e3 << std::setw(10) << h.max / 1e3 << "\n";
+    }
+    os.flags(flags);
+    os.precision(prec);
+}
+
+void setDumpAtGameEnd(bool on) { gDumpAtGameEnd.store(on, kRelaxed); }
+bool dumpAtGameEnd() { return gDumpAtGameEnd.load(kRelaxed); }
+
+} // namespace Instrument
+
+// ---------- Allocation hook ----------
+#if MINIRISK_INSTRUMENT
+void* operator new(std::size_t n) {
+    Instrument::count(Instrument::kAllocations);
+    Instrument::count(Instrument::kAllocBytes, n);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
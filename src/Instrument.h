@@ -0,0 +1,180 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ------------------------------------------------------------
+// Instrument — runtime counters, phase timers and latency
+// histograms
+//  • Every thread writes its own block (plain relaxed stores, no
+//    shared cache lines); snapshot() sums the blocks on demand
+//  • A block outlives its thread: the next thread to start takes
+//    it over and keeps adding to its totals, so short-lived threads
+//    cost no memory beyond the most ever alive at once
+//  • Timers read the TSC where there is one (a clock_gettime per
+//    timer edge costs more than most decisions being timed);
+//    ticks are converted to nanoseconds when a snapshot is taken
+//  • Latency histograms are log-linear (HDR-style: 32 sub-buckets
+//    per power of two, ≤ 3% relative error)
+//  • Build with -DMINIRISK_INSTRUMENT=0 to compile every MR_*
+//    macro (and the allocation hook) out entirely
+// ------------------------------------------------------------
+#ifndef MINIRISK_INSTRUMENT
+#define MINIRISK_INSTRUMENT 1
+#endif
+
+namespace Instrument {
+
+    constexpr bool kEnabled = MINIRISK_INSTRUMENT != 0;
+
+    enum Counter : int {
+        kBattles,               // applyBattle rounds + applyBlitz battles
+        kDiceRounds,            // dice rounds (simulateBattleOnce, BattleBatch)
+        kCaptures,
+        kRulesQueries,          // ownership / legality / status queries
+        kEndgameNodes,          // Endgame::Solver expansions
+        kAllocations,           // operator new calls
+        kAllocBytes,
+        kCounterCount
+    };
+
+    enum Phase : int { kReinforcePhase, kAttackPhase, kFortifyPhase, kPhaseCount };
+
+    enum Decision : int {
+        kChooseReinforcement, kChooseAttack, kChooseFortify, kDecisionCount
+    };
+
+    const char* name(Counter c);
+    const char* name(Phase p);
+    const char* name(Decision d);
+
+    // ---------- Histogram (report form) ----------
+    struct Histogram {
+        static constexpr int kSubBits = 5;
+        static constexpr int kSub = 1 << kSubBits;
+        static constexpr int kBuckets = (64 - kSubBits + 1) * kSub;
+
+        static int bucketOf(std::uint64_t v);
+        static std::uint64_t lowerBound(int bucket);
+
+        void record(std::uint64_t v);
+        double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+        std::uint64_t percentile(double q) const;   // q in [0, 1]; bucket midpoint
+
+        std::uint64_t buckets[kBuckets]{};
+        std::uint64_t count{0}, sum{0}, max{0};
+    };
+
+    // ---------- Totals across threads ----------
+    struct Report {
+        std::uint64_t counters[kCounterCount]{};
+        std::uint64_t phaseNs[kPhaseCount]{};
+        std::uint64_t phaseTurns[kPhaseCount]{};            // turns that reached the phase
+        Histogram decisions[kDecisionCount];                // nanoseconds
+    };
+
+    Report snapshot();
+    std::uint64_t total(Counter c);                 // one counter, summed over threads
+    void reset();                                   // call while no game is running
+    void dump(std::ostream& os);                    // snapshot() as a text table
+    void dump(std::ostream& os, const Report& r);
+
+    // Game::play dumps to stderr when a game ends if this is set.
+    void setDumpAtGameEnd(bool on);
+    bool dumpAtGameEnd();
+
+    // ---------- Per-thread recording ----------
+    namespace detail {
+        struct ThreadBlock {
+            std::atomic<std::uint64_t> counters[kCounterCount];
+            std::atomic<std::uint64_t> phaseTicks[kPhaseCount];
+            std::atomic<std::uint64_t> phaseTurns[kPhaseCount];
+            std::atomic<std::uint64_t> decisionSum[kDecisionCount];     // ticks
+            std::atomic<std::uint64_t> decisionMax[kDecisionCount];
+            std::atomic<std::uint64_t> decisions[kDecisionCount][Histogram::kBuckets];
+            std::atomic<bool> free;          // owner exited; the next new thread takes it over
+            ThreadBlock* next;
+        };
+
+        inline thread_local ThreadBlock* tls = nullptr;   // constant-initialised: no TLS guard
+        ThreadBlock* registerThread();
+
+        inline ThreadBlock& block() {
+            ThreadBlock* b = tls;
+            return b ? *b : *registerThread();
+        }
+
+        // Only the owning thread writes a block, so no RMW is needed.
+        inline void bump(std::atomic<std::uint64_t>& c, std::uint64_t n) {
+            c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+    } // namespace detail
+
+    inline void count(Counter c, std::uint64_t n = 1) {
+        detail::bump(detail::block().counters[c], n);
+    }
+
+    // A phase's time is spread over several timers per turn (the
+    // decisions and the moves that follow them); enterPhase() counts
+    // the turn once, so phaseNs / phaseTurns is per turn.
+    void enterPhase(Phase p);
+    void addPhase(Phase p, std::uint64_t ticks);    // time only
+    void addDecision(Decision d, std::uint64_t ticks);
+
+    // ---------- Scoped timers ----------
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer(Phase p) : p_(p), t0_(detail::ticks()) {}
+        ~PhaseTimer() { addPhase(p_, detail::ticks() - t0_); }
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        Phase p_;
+        std::uint64_t t0_;
+    };
+
+    class DecisionTimer {
+    public:
+        explicit DecisionTimer(Decision d) : d_(d), t0_(detail::ticks()) {}
+        ~DecisionTimer() { addDecision(d_, detail::ticks() - t0_); }
+        DecisionTimer(const DecisionTimer&) = delete;
+        DecisionTimer& operator=(const DecisionTimer&) = delete;
+
+    private:
+        Decision d_;
+        std::uint64_t t0_;
+    };
+
+} // namespace Instrument
+
+// ---------- Recording macros ----------
+#if MINIRISK_INSTRUMENT
+#define MR_INSTR_CAT2(a, b) a##b
+#define MR_INSTR_CAT(a, b) MR_INSTR_CAT2(a, b)
+#define MR_COUNT(c) ::Instrument::count(::Instrument::c)
+#define MR_COUNT_N(c, n) ::Instrument::count(::Instrument::c, (n))
+#define MR_ENTER_PHASE(p) ::Instrument::enterPhase(::Instrument::p)
+#define MR_TIME_PHASE(p) ::Instrument::PhaseTimer MR_INSTR_CAT(mrPhase_, __LINE__)(::Instrument::p)
+#define MR_TIME_DECISION(d) \
+    ::Instrument::DecisionTimer MR_INSTR_CAT(mrDecision_, __LINE__)(::Instrument::d)
+#else
+#define MR_COUNT(c) ((void)0)
+#define MR_COUNT_N(c, n) ((void)0)
+#define MR_ENTER_PHASE(p) ((void)0)
+#define MR_TIME_PHASE(p) ((void)0)
+#define MR_TIME_DECISION(d) ((void)0)
+#endif
@@ -0,0 +1,578 @@
+#include "MCTS.h"
+#include "Playout.h"
+#include "Rules.h"
+#include "TransTable.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMaxTreeAttacks = 8;   // attack decisions per turn inside the tree
+constexpr int kPlayoutUndoSlack = 512; // undo entries kept free before each playout turn
+constexpr int kRaceCheckEvery = 32;  // iterations between deadline / elimination checks
+constexpr int kRaceMinVisits = 8;    // root visits before a move's interval is trusted
+
+// ---------- Turn state ----------
+enum class Phase : std::uint8_t { Reinforce, Attack, CaptureMove, Fortify, Done };
+
+struct State {
+    Board board;
+    PlayerId me{PlayerId::None};
+    Phase phase{Phase::Done};
+    int reinforcements{0};
+    int attacks{0};
+    TerrId capFrom{-1}, capTo{-1};
+};
+
+enum class ActionType : std::uint8_t { Reinforce, Attack, EndAttack, Move, Fortify, SkipFortify };
+
+struct Action {
+    ActionType type{ActionType::SkipFortify};
+    TerrId a{-1};
+    TerrId b{-1};
+    int amount{0};
+};
+
+// ---------- Arena node ----------
+struct Node {
+    Action action;                 // move leading here (decision children only)
+    int firstChild{-1};            // decision: contiguous block; chance: sibling list head
+    int childCount{0};
+    int nextSibling{-1};           // chance outcomes
+    std::uint32_t outcome{0};      // chance outcome key
+    bool expanded{false};
+    bool chance{false};            // children are sampled battle outcomes
+    int visits{0};
+    double value{0.0};
+};
+
+// ---------- Playout helpers ----------
+int applyReinforcementBonus(Board& b, PlayerId p) {
+    TerrId bonus = -1;
+    if (Rules::chainOf5BonusTarget(b, p, bonus)) b.addArmies(bonus, 5);
+    return Rules::baseReinforcements(b, p);
+}
+
+// Score in [0, 1] for `me`. Decided games score outside the heuristic band
+// [0.1, 0.9], and sooner wins (later losses) score better, so the search
+// still has a gradient once every line wins.
+double evaluate(const Board& b, PlayerId me, int turnsPlayed) {
+    const double early = 0.01 * std::min(turnsPlayed, 9);
+    switch (b.status()) {
+        case GameState::Player1Wins: return me == PlayerId::P1 ? 1.0 - early : early;
+        case GameState::Player2Wins: return me == PlayerId::P2 ? 1.0 - early : early;
+        default: break;
+    }
+    double terr = static_cast<double>(b.ownedCount(me)) /
+                  std::max(1, b.ownedCount(PlayerId::P1) + b.ownedCount(PlayerId::P2));
+    double arm = static_cast<double>(b.armyTotal(me)) /
+                 std::max(1, b.armyTotal(PlayerId::P1) + b.armyTotal(PlayerId::P2));
+    return 0.1 + 0.8 * (0.7 * terr + 0.3 * arm);
+}
+
+// ---------- Action generation ----------
+void legalActions(const State& s, std::vector<Action>& out) {
+    out.clear();
+    const Board& b = s.board;
+    const PlayerId p = s.me;
+
+    switch (s.phase) {
+    case Phase::Reinforce: {
+        const auto& front = b.frontier(p);
+        if (front.empty()) {
+            for (TerrId t : Rules::owned(b, p)) out.push_back({ActionType::Reinforce, t, -1, s.reinforcements});
+        } else {
+            for (TerrId t : Rules::borders(b, p)) out.push_back({ActionType::Reinforce, t, -1, s.reinforcements});
+        }
+        break;
+    }
+    case Phase::Attack:
+        out.push_back({ActionType::EndAttack, -1, -1, 0});
+        if (s.attacks >= kMaxTreeAttacks) break;
+        for (TerrId from : Rules::borders(b, p)) {
+            if (b.armies(from) < 2) continue;
+            for (TerrId to : b.neighbors(from))
+                if (Rules::canAttack(b, from, to, p)) out.push_back({ActionType::Attack, from, to, 0});
+        }
+        break;
+    case Phase::CaptureMove: {
+        int maxMove = std::max(1, b.armies(s.capFrom) - 1);
+        out.push_back({ActionType::Move, s.capFrom, s.capTo, maxMove});
+        if (maxMove > 2) out.push_back({ActionType::Move, s.capFrom, s.capTo, (maxMove + 1) / 2});
+        if (maxMove > 1) out.push_back({ActionType::Move, s.capFrom, s.capTo, 1});
+        break;
+    }
+    case Phase::Fortify:
+        out.push_back({ActionType::SkipFortify, -1, -1, 0});
+        for (TerrId from : Rules::owned(b, p)) {
+            if (b.armies(from) < 2 || b.onFrontier(from)) continue;
+            for (TerrId to : b.neighbors(from))
+                if (b.onFrontier(to) && Rules::canFortify(b, from, to, p))
+                    out.push_back({ActionType::Fortify, from, to, b.armies(from) - 1});
+        }
+        break;
+    case Phase::Done:
+        break;
+    }
+}
+
+// Applies a non-chance action.
+void applyAction(State& s, const Action& a) {
+    switch (a.type) {
+        case ActionType::Reinforce:
+            s.board.addArmies(a.a, a.amount);
+            s.phase = Phase::Attack;
+            break;
+        case ActionType::EndAttack:
+            s.phase = Phase::Fortify;
+            break;
+        case ActionType::Move:
+            Rules::moveAfterCapture(s.board, a.a, a.b, a.amount);
+            s.phase = Phase::Attack;
+            break;
+        case ActionType::Fortify:
+            Rules::moveAfterCapture(s.board, a.a, a.b, a.amount);
+            s.phase = Phase::Done;
+            break;
+        case ActionType::SkipFortify:
+            s.phase = Phase::Done;
+            break;
+        case ActionType::Attack:
+            break;   // resolved by resolveAttack
+    }
+}
+
+// Samples the chance outcome of an attack action and returns its key.
+std::uint32_t resolveAttack(State& s, const Action& a, Rng::Stream& rng) {
+    bool took = Playout::fightOut(s.board, a.a, a.b, s.me, rng);
+    ++s.attacks;
+    if (took) {
+        s.phase = Phase::CaptureMove;
+        s.capFrom = a.a;
+        s.capTo = a.b;
+    }
+    std::uint32_t aLeft = static_cast<std::uint32_t>(s.board.armies(a.a));
+    std::uint32_t dLeft = took ? 0u : static_cast<std::uint32_t>(s.board.armies(a.b));
+    return (aLeft << 16) ^ dLeft ^ (took ? 0x80000000u : 0u);
+}
+
+// ---------- One tree (one thread) ----------
+class Tree {
+public:
+    Tree(const State& root, const MCTS::Config& cfg, Rng::Stream rng, TransTable* tt)
+        : root_(root), cfg_(cfg), rng_(rng), tt_(tt), work_(root) {
+        nodes_.reserve(static_cast<size_t>(std::max(1, cfg.maxNodes)));
+        nodes_.emplace_back();
+        work_.board.beginRecording();
+    }
+
+    void run(int iterations, Clock::time_point deadline, bool timed) {
+        for (int it = 0; it < iterations; ++it) {
+            if (it % kRaceCheckEvery == 0) {
+                if (timed && Clock::now() >= deadline) break;
+                if (it > 0 && cfg_.raceDelta > 0.0 && raceDecided(iterations - it)) break;
+            }
+            iterate();
+        }
+    }
+
+    // Root children in generation order (identical across trees).
+    const Node& root() const { return nodes_[0]; }
+    const Node& node(int i) const { return nodes_[i]; }
+
+private:
+    // Successive elimination at the root. A move's interval is its
+    // mean ± z·sd/√n from its own playout values, with z set for error
+    // rate δ across all K moves at once (sub-Gaussian tail, union
+    // bound). Moves whose upper bound falls below the leader's lower
+    // bound are no longer selected. Done once one move is left, or
+    // when the remaining iterations could not change the most-visited
+    // move (the final pick).
+    bool raceDecided(int remaining) {
+        const Node& r = nodes_[0];
+        if (r.childCount < 2 || rootSq_.empty()) return false;
+        if (pruned_.empty()) pruned_.assign(r.childCount, 0);
+
+        int most = -1, second = 0;
+        for (int k = 0; k < r.childCount; ++k) {
+            const int v = nodes_[r.firstChild + k].visits;
+            if (most < 0 || v > nodes_[r.firstChild + most].visits) {
+                if (most >= 0) second = nodes_[r.firstChild + most].visits;
+                most = k;
+            } else {
+                second = std::max(second, v);
+            }
+        }
+        if (nodes_[r.firstChild + most].visits - second > remaining) return true;
+
+        const double z = std::sqrt(2.0 * std::log(2.0 * r.childCount / cfg_.raceDelta));
+        auto interval = [&](int k, double& mean) {
+            const Node& c = nodes_[r.firstChild + k];
+            mean = c.value / c.visits;
+            const double var = std::max(0.0, rootSq_[k] / c.visits - mean * mean);
+            return z * std::sqrt(var / c.visits);
+        };
+
+        int leader = -1;
+        double leaderMean = -1.0;
+        for (int k = 0; k < r.childCount; ++k) {
+            if (pruned_[k]) continue;
+            const Node& c = nodes_[r.firstChild + k];
+            if (c.visits < kRaceMinVisits) return false;
+            const double m = c.value / c.visits;
+            if (m > leaderMean) { leaderMean = m; leader = k; }
+        }
+        double m = 0.0;
+        const double floor = leaderMean - interval(leader, m);
+
+        int live = 0;
+        for (int k = 0; k < r.childCount; ++k) {
+            if (pruned_[k]) continue;
+            if (k != leader) {
+                const double hw = interval(k, m);
+                if (m + hw < floor) { pruned_[k] = 1; continue; }
+            }
+            ++live;
+        }
+        return live == 1;
+    }
+
+    int alloc() {
+        if (static_cast<int>(nodes_.size()) >= cfg_.maxNodes) return -1;
+        nodes_.emplace_back();
+        return static_cast<int>(nodes_.size()) - 1;
+    }
+
+    bool expand(int n, const State& s) {
+        legalActions(s, scratch_);
+        if (scratch_.empty()) { nodes_[n].expanded = true; return false; }
+        if (static_cast<int>(nodes_.size() + scratch_.size()) > cfg_.maxNodes) return false;
+        int first = static_cast<int>(nodes_.size());
+        for (const auto& a : scratch_) {
+            Node c;
+            c.action = a;
+            c.chance = (a.type == ActionType::Attack);
+            nodes_.push_back(c);
+        }
+        nodes_[n].firstChild = first;
+        nodes_[n].childCount = static_cast<int>(scratch_.size());
+        nodes_[n].expanded = true;
+        return true;
+    }
+
+    int selectChild(int n) const {
+        const Node& p = nodes_[n];
+        const double logN = std::log(static_cast<double>(std::max(1, p.visits)));
+        int best = -1;
+        double bestScore = -1.0;
+        const bool root = (n == 0 && !pruned_.empty());
+        for (int k = 0; k < p.childCount; ++k) {
+            if (root && pruned_[k]) continue;
+            const Node& c = nodes_[p.firstChild + k];
+            if (c.visits == 0) return p.firstChild + k;
+            double score = c.value / c.visits + cfg_.exploration * std::sqrt(logN / c.visits);
+            if (score > bestScore) { bestScore = score; best = p.firstChild + k; }
+        }
+        return best;
+    }
+
+    int outcomeChild(int n, std::uint32_t key) {
+        for (int c = nodes_[n].firstChild; c >= 0; c = nodes_[c].nextSibling)
+            if (nodes_[c].outcome == key) return c;
+        int c = alloc();
+        if (c < 0) return -1;
+        nodes_[c].outcome = key;
+        nodes_[c].nextSibling = nodes_[n].firstChild;
+        nodes_[n].firstChild = c;
+        ++nodes_[n].childCount;
+        return c;
+    }
+
+    // Iterations play on one working board and unmake back to the root,
+    // so no per-iteration board copy is made.
+    void iterate() {
+        State& s = work_;
+        path_.clear();
+        int n = 0;
+        path_.push_back(n);
+        bool grew = false;
+
+        while (s.phase != Phase::Done && s.board.status() == GameState::Ongoing) {
+            Node& cur = nodes_[n];
+            if (cur.chance) {
+                std::uint32_t key = resolveAttack(s, cur.action, rng_);
+                int c = outcomeChild(n, key);
+                if (c < 0) break;
+                n = c;
+                path_.push_back(n);
+                continue;
+            }
+            if (grew) break;                         // one new decision level per iteration
+            if (!cur.expanded) {
+                if (!expand(n, s)) break;
+                grew = true;
+            }
+            if (nodes_[n].childCount == 0) break;
+            int c = selectChild(n);
+            const Action a = nodes_[c].action;
+            if (a.type != ActionType::Attack) applyAction(s, a);
+            n = c;
+            path_.push_back(n);
+        }
+
+        double v = rollout(s);
+        for (int i : path_) {
+            nodes_[i].visits += 1;
+            nodes_[i].value += v;
+        }
+        if (path_.size() > 1) {                  // root child: second moment for the race
+            const Node& r = nodes_[0];
+            if (rootSq_.empty()) rootSq_.assign(r.childCount, 0.0);
+            rootSq_[path_[1] - r.firstChild] += v * v;
+        }
+        restoreRoot();
+    }
+
+    void restoreRoot() {
+        if (!work_.board.undoTo(0)) {            // undo stack overflowed: copy afresh
+            work_.board = root_.board;
+            work_.board.beginRecording();
+        }
+        work_.me = root_.me;
+        work_.phase = root_.phase;
+        work_.reinforcements = root_.reinforcements;
+        work_.attacks = root_.attacks;
+        work_.capFrom = root_.capFrom;
+        work_.capTo = root_.capTo;
+    }
+
+    // Every leaf is played out. With a table, the sample joins the
+    // leaf's pool and a leaf seen often enough (by any tree) backs up
+    // the pooled mean, which keeps improving, instead of one sample.
+    double rollout(State& s) {
+        Board& b = s.board;
+        PlayerId p = other(s.me);
+        const std::uint64_t key = tt_ ? leafKey(s) : 0;
+
+        const auto& policy = cfg_.playout;
+        int t = 0;
+        for (; t < cfg_.playoutTurns && b.status() == GameState::Ongoing &&
+               b.undoRoom() >= kPlayoutUndoSlack; ++t) {
+            if (policy) policy(b, p, rng_);
+            else MCTS::greedyPlayoutTurn(b, p, rng_);
+            p = other(p);
+        }
+        const double v = evaluate(b, s.me, t);
+        if (!tt_) return v;
+        tt_->addSample(key, v);
+        TransTable::Entry pooled;
+        if (tt_->probe(key, pooled) && static_cast<int>(pooled.count) >= cfg_.ttTrust)
+            return pooled.mean;
+        return v;
+    }
+
+    // Board, side and where in the turn the leaf is: the same armies
+    // before and after reinforcing, or with attacks left to make, are
+    // different positions. Called before the playout changes the board.
+    static std::uint64_t leafKey(const State& s) {
+        const std::uint64_t ctx = static_cast<std::uint64_t>(s.phase) |
+                                  static_cast<std::uint64_t>(s.reinforcements & 0xffff) << 8 |
+                                  static_cast<std::uint64_t>(s.attacks & 0xff) << 24 |
+                                  static_cast<std::uint64_t>((s.capFrom + 1) & 0xffff) << 32 |
+                                  static_cast<std::uint64_t>((s.capTo + 1) & 0xffff) << 48;
+        return s.board.hash(s.me) ^ splitmix64(ctx);
+    }
+
+    const State& root_;
+    const MCTS::Config& cfg_;
+    Rng::Stream rng_;
+    TransTable* tt_;
+    State work_;
+    std::vector<Node> nodes_;
+    std::vector<int> path_;
+    std::vector<Action> scratch_;
+    std::vector<char> pruned_;               // root children out of the race
+    std::vector<double> rootSq_;             // root children: sum of squared values
+};
+
+// Runs the root-parallel search and returns the chosen root action.
+bool search(const State& root, const MCTS::Config& cfg, std::uint32_t seed,
+            TransTable* tt, Action& best) {
+    std::vector<Action> rootActions;
+    legalActions(root, rootActions);
+    if (rootActions.empty()) return false;
+    if (rootActions.size() == 1) { best = rootActions[0]; return true; }
+
+    const unsigned threads = std::max(1u, cfg.threads);
+    const Budget budget = cfg.budget.bounded() ? cfg.budget : MCTS::Config{}.budget;
+    const int work = budget.work > 0 ? budget.work : std::numeric_limits<int>::max();
+    const int perThread = std::max(1, static_cast<int>(
+        (static_cast<long long>(work) + threads - 1) / threads));
+    const bool timed = budget.timeMs > 0.0;
+    const auto deadline = Clock::now() +
+        std::chrono::microseconds(static_cast<long long>(budget.timeMs * 1000.0));
+
+    Rng::Stream master(seed);
+    std::vector<std::unique_ptr<Tree>> trees;
+    for (unsigned t = 0; t < threads; ++t)
+        trees.push_back(std::make_unique<Tree>(root, cfg, master.split(t), tt));
+
+    // Each tree has its own seeded stream, so without a deadline or a
+    // shared table the result depends on the tree count only.
+    if (threads == 1) {
+        trees[0]->run(perThread, deadline, timed);
+    } else if (cfg.pool) {
+        cfg.pool->parallelFor(threads, [&](std::size_t t) {
+            trees[t]->run(perThread, deadline, timed);
+        });
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+            workers.emplace_back([&, t]{ trees[t]->run(perThread, deadline, timed); });
+        for (auto& w : workers) w.join();
+    }
+
+    // Sum root statistics across trees (children share generation order).
+    std::vector<long long> visits(rootActions.size(), 0);
+    std::vector<double> value(rootActions.size(), 0.0);
+    for (const auto& tree : trees) {
+        const Node& r = tree->root();
+        for (int k = 0; k < r.childCount; ++k) {
+            visits[k] += tree->node(r.firstChild + k).visits;
+            value[k] += tree->node(r.firstChild + k).value;
+        }
+    }
+    size_t pick = 0;
+    for (size_t k = 1; k < rootActions.size(); ++k) {
+        double mk = visits[k] ? value[k] / visits[k] : 0.0;
+        double mp = visits[pick] ? value[pick] / visits[pick] : 0.0;
+        if (visits[k] > visits[pick] || (visits[k] == visits[pick] && mk > mp)) pick = k;
+    }
+    best = rootActions[pick];
+    return true;
+}
+
+State makeState(const Board& b, PlayerId p, Phase phase) {
+    State s;
+    s.board = b;
+    s.me = p;
+    s.phase = phase;
+    return s;
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+namespace MCTS {
+
+// ---------- Playout policies ----------
+void greedyPlayoutTurn(Board& b, PlayerId p, Rng::Stream& rng) {
+    Playout::greedyTurn(b, p, rng);
+}
+
+void randomPlayoutTurn(Board& b, PlayerId p, Rng::Stream& rng) {
+    int base = applyReinforcementBonus(b, p);
+    const auto& front = b.frontier(p);
+    if (front.empty()) return;
+    b.addArmies(front[rng.below(static_cast<std::uint32_t>(front.size()))], base);
+
+    for (int k = 0; k < Playout::kMaxAttacks && !front.empty(); ++k) {
+        TerrId from = front[rng.below(static_cast<std::uint32_t>(front.size()))];
+        if (b.armies(from) < 2) continue;
+        const auto& nb = b.neighbors(from);
+        TerrId to = nb[rng.below(static_cast<std::uint32_t>(nb.size()))];
+        if (!Rules::canAttack(b, from, to, p)) continue;
+        if (Playout::fightOut(b, from, to, p, rng))
+            Rules::moveAfterCapture(b, from, to, b.armies(from) - 1);
+        if (b.status() != GameState::Ongoing) return;
+    }
+}
+
+// ---------- Engine ----------
+Engine::Engine(Config cfg) : cfg_(std::move(cfg)) {
+    if (cfg_.ttLog2 > 0) tt_ = std::make_shared<TransTable>(cfg_.ttLog2);
+}
+
+TerrId Engine::chooseReinforcement(const Board& b, PlayerId p, int reinforcements, std::uint32_t seed) {
+    if (tt_) tt_->clear();                 // a new turn: nothing pooled applies
+    State s = makeState(b, p, Phase::Reinforce);
+    s.reinforcements = reinforcements;
+    Action a;
+    return search(s, cfg_, seed, tt_.get(), a) ? a.a : -1;
+}
+
+RandomAI::AttackPlan Engine::chooseAttack(const Board& b, PlayerId p, std::uint32_t seed) {
+    RandomAI::AttackPlan plan;
+    State s = makeState(b, p, Phase::Attack);
+    Action a;
+    if (search(s, cfg_, seed, tt_.get(), a) && a.type == ActionType::Attack) {
+        plan.from = a.a;
+        plan.to = a.b;
+        plan.valid = true;
+    }
+    return plan;
+}
+
+int Engine::chooseMoveAfterCapture(const Board& b, PlayerId p, TerrId from, TerrId to,
+                                   int maxMove, std::uint32_t seed) {
+    State s = makeState(b, p, Phase::CaptureMove);
+    s.capFrom = from;
+    s.capTo = to;
+    Action a;
+    if (!search(s, cfg_, seed, tt_.get(), a)) return maxMove;
+    return std::max(1, std::min(maxMove, a.amount));
+}
+
+RandomAI::FortifyPlan Engine::chooseFortify(const Board& b, PlayerId p, std::uint32_t seed) {
+    RandomAI::FortifyPlan plan;
+    State s = makeState(b, p, Phase::Fortify);
+    Action a;
+    if (search(s, cfg_, seed, tt_.get(), a) && a.type == ActionType::Fortify) {
+        plan.from = a.a;
+        plan.to = a.b;
+        plan.amount = a.amount;
+        plan.valid = true;
+    }
+    return plan;
+}
+
+} // namespace MCTS
+
+// ---------- MCTSController ----------
+MCTSController::MCTSController(std::uint32_t seed, MCTS::Config cfg)
+    : engine_(std::move(cfg)), seed_(seed) {}
+
+MCTSController::MCTSController(std::uint32_t seed, Difficulty level)
+    : MCTSController(seed, MCTS::Config::forLevel(level)) {}
+
+TerrId MCTSController::chooseReinforcement(const Board& b, PlayerId p, int reinforcements) {
+    return engine_.chooseReinforcement(b, p, reinforcements, seed_++);
+}
+
+bool MCTSController::chooseAttack(const Board& b, PlayerId p, int /*attacksSoFar*/,
+                                  IO::AttackChoice& out) {
+    auto plan = engine_.chooseAttack(b, p, seed_++);
+    if (!plan.valid) return false;
+    out = {plan.from, plan.to};
+    return true;
+}
+
+int MCTSController::chooseMoveAfterCapture(const Board& b, TerrId from, TerrId to, int maxMove) {
+    return engine_.chooseMoveAfterCapture(b, b.owner(from), from, to, maxMove, seed_++);
+}
+
+bool MCTSController::chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) {
+    auto plan = engine_.chooseFortify(b, p, seed_++);
+    if (!plan.valid) return false;
+    out = {plan.from, plan.to, plan.amount};
+    return true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "Board.h"
+#include "Budget.h"
+#include "Controller.h"
+#include "RandomAI.h"
+#include "Rng.h"
+#include "TransTable.h"
+#include "Types.h"
+
+class ThreadPool;
+
+// ------------------------------------------------------------
+// MCTS — Monte Carlo Tree Search opponent
+// ------------------------------------------------------------
+// Searches the rest of the current player's turn:
+//   reinforce → attack* (each attack is a chance node whose
+//   children are sampled battle outcomes) → capture moves →
+//   fortify → end of turn, then plays `playoutTurns` further
+//   turns with the playout policy and scores the position.
+// Root-parallel: each thread grows its own tree in an arena
+// (a pre-reserved node vector, indices instead of pointers) and
+// the root visit counts are summed. Optionally (ttLog2 > 0) leaf
+// values are pooled across trees and the decisions of one turn in
+// a lock-free TransTable keyed by the board's Zobrist hash plus the
+// turn phase. The search is anytime and stops at its
+// Budget; root moves whose confidence interval falls below the
+// leader's are dropped (successive elimination), and the search
+// ends early once a single root move is left. The choose*
+// functions mirror RandomAI::choose* so the engine is a drop-in
+// replacement.
+//
+namespace MCTS {
+
+    // Plays one whole turn for p (reinforce, attack, capture moves).
+    using PlayoutPolicy = std::function<void(Board& b, PlayerId p, Rng::Stream& rng)>;
+
+    // Default policy: reinforce the strongest frontier territory, then
+    // attack while the exact capture odds are at least 50%.
+    void greedyPlayoutTurn(Board& b, PlayerId p, Rng::Stream& rng);
+
+    // Cheaper policy: random frontier reinforcement, random legal attacks.
+    void randomPlayoutTurn(Board& b, PlayerId p, Rng::Stream& rng);
+
+    struct Config {
+        Budget budget{4000, 0.0};    // playouts / wall clock per decision (all threads)
+        double raceDelta{0.05};      // root elimination error rate (0 = never stop early)
+        unsigned threads{1};         // independent root-parallel trees
+        ThreadPool* pool{nullptr};   // runs the trees (nullptr = a thread per tree)
+        int maxNodes{1 << 20};       // arena size per tree
+        int playoutTurns{6};         // turns simulated past the end of our turn
+        double exploration{0.5};     // UCT constant
+        PlayoutPolicy playout;       // empty = greedyPlayoutTurn
+        int ttLog2{0};               // shared leaf-value table size (0 = off; with
+                                     // threads > 1 it makes results timing-dependent)
+        int ttTrust{8};              // pooled samples before a leaf backs up their mean
+
+        static Config forLevel(Difficulty d) {
+            Config c;
+            c.budget = budgetFor(d);
+            if (d == Difficulty::Analysis) c.raceDelta = 0.01;
+            return c;
+        }
+    };
+
+    class Engine {
+    public:
+        explicit Engine(Config cfg = {});
+
+        TerrId chooseReinforcement(const Board& b, PlayerId p,
+                                   int reinforcements, std::uint32_t seed);
+        RandomAI::AttackPlan chooseAttack(const Board& b, PlayerId p, std::uint32_t seed);
+        int chooseMoveAfterCapture(const Board& b, PlayerId p, TerrId from, TerrId to,
+                                   int maxMove, std::uint32_t seed);
+        RandomAI::FortifyPlan chooseFortify(const Board& b, PlayerId p, std::uint32_t seed);
+
+        const Config& config() const { return cfg_; }
+        void setBudget(const Budget& b) { cfg_.budget = b; }
+
+    private:
+        Config cfg_;
+        std::shared_ptr<TransTable> tt_;   // shared by all trees, cleared every turn
+    };
+
+} // namespace MCTS
+
+// ---------- Controller adapter ----------
+class MCTSController : public Controller {
+public:
+    MCTSController(std::uint32_t seed, MCTS::Config cfg = {});
+    MCTSController(std::uint32_t seed, Difficulty level);
+
+    void setBudget(const Budget& b) { engine_.setBudget(b); }
+
+    TerrId chooseReinforcement(const Board& b, PlayerId p, int reinforcements) override;
+    bool chooseAttack(const Board& b, PlayerId p, int attacksSoFar,
+                      IO::AttackChoice& out) override;
+    int chooseMoveAfterCapture(const Board& b, TerrId from, TerrId to, int maxMove) override;
+    bool chooseFortify(const Board& b, PlayerId p, IO::FortifyChoice& out) override;
+
+private:
+    MCTS::Engine engine_;
+    std::uint32_t seed_;
+};
@@ -2,7 +2,10 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <cstdint>
 #include <random>
+#include <unordered_set>
+#include "Rng.h"
 
 namespace {
 
@@ -120,6 +123,133 @@ std::vector<std::pair<int,int>> placePoints(std::mt19937& rng) {
     return pts;
 }
 
+// ---------- Scalable generator ----------
+using Pt = std::pair<int,int>;
+
+inline std::int64_t dist2(const Pt& a, const Pt& b) {
+    std::int64_t dr = a.first - b.first, dc = a.second - b.second;
+    return dr * dr + dc * dc;
+}
+
+// Random sequential Poisson-disk sampling on the integer canvas:
+// cells are visited in shuffled order and kept unless a kept point
+// lies within Chebyshev distance kMinSep (checked on an occupancy
+// grid in O(1)). If spacing cannot fit n points, the remainder is
+// placed on any free cell, as build20's fallback does.
+std::vector<Pt> placePointsGrid(int n, int rows, int cols, Rng::Stream& rng) {
+    const int cells = rows * cols;
+    std::vector<int> order(cells);
+    for (int i = 0; i < cells; ++i) order[i] = i;
+    for (int i = cells - 1; i > 0; --i)
+        std::swap(order[i], order[rng.below(static_cast<std::uint32_t>(i + 1))]);
+
+    std::vector<char> blocked(cells, 0), used(cells, 0);
+    std::vector<Pt> pts;
+    pts.reserve(n);
+    for (int k = 0; k < cells && static_cast<int>(pts.size()) < n; ++k) {
+        const int cell = order[k];
+        if (blocked[cell]) continue;
+        const int r = cell / cols, c = cell % cols;
+        pts.emplace_back(r, c);
+        used[cell] = 1;
+        for (int dr = -(kMinSep - 1); dr <= kMinSep - 1; ++dr)
+            for (int dc = -(kMinSep - 1); dc <= kMinSep - 1; ++dc) {
+                int rr = r + dr, cc = c + dc;
+                if (rr >= 0 && rr < rows && cc >= 0 && cc < cols) blocked[rr * cols + cc] = 1;
+            }
+    }
+    for (int k = 0; k < cells && static_cast<int>(pts.size()) < n; ++k)
+        if (!used[order[k]]) {
+            used[order[k]] = 1;
+            pts.emplace_back(order[k] / cols, order[k] % cols);
+        }
+    return pts;
+}
+
+struct Cand {
+    std::int64_t d;
+    int a, b;
+    bool operator<(const Cand& o) const {
+        if (d != o.d) return d < o.d;
+        return a != o.a ? a < o.a : b < o.b;
+    }
+    bool operator==(const Cand& o) const { return a == o.a && b == o.b; }
+};
+
+// Each point's k nearest neighbours (ties by index) as deduplicated
+// edges sorted by length, found by scanning rings of a bucket grid.
+std::vector<Cand> nearestCandidates(const std::vector<Pt>& pts, int rows, int cols, int k) {
+    constexpr int kBucket = 4;
+    const int n = static_cast<int>(pts.size());
+    if (k <= 0) return {};
+    const int br = (rows + kBucket - 1) / kBucket, bc = (cols + kBucket - 1) / kBucket;
+    std::vector<int> start(br * bc + 1, 0), items(n);
+    auto bucketOf = [&](const Pt& p) { return (p.first / kBucket) * bc + p.second / kBucket; };
+    for (const Pt& p : pts) ++start[bucketOf(p) + 1];
+    for (int i = 0; i < br * bc; ++i) start[i + 1] += start[i];
+    {
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int i = 0; i < n; ++i) items[fill[bucketOf(pts[i])]++] = i;
+    }
+
+    std::vector<Cand> out;
+    out.reserve(static_cast<size_t>(n) * k);
+    std::vector<Cand> best;                 // max-heap of the k nearest so far
+    for (int i = 0; i < n; ++i) {
+        best.clear();
+        const int pr = pts[i].first / kBucket, pc = pts[i].second / kBucket;
+        for (int ring = 0; ring <= std::max(br, bc); ++ring) {
+            if (static_cast<int>(best.size()) == k && ring > 0) {
+                std::int64_t gap = static_cast<std::int64_t>(ring - 1) * kBucket + 1;
+                if (gap * gap > best.front().d) break;
+            }
+            for (int r = pr - ring; r <= pr + ring; ++r) {
+                if (r < 0 || r >= br) continue;
+                const bool edgeRow = (r == pr - ring || r == pr + ring);
+                for (int c = pc - ring; c <= pc + ring; c += (edgeRow ? 1 : 2 * ring)) {
+                    if (c >= 0 && c < bc) {
+                        for (int s = start[r * bc + c]; s < start[r * bc + c + 1]; ++s) {
+                            const int j = items[s];
+                            if (j == i) continue;
+                            Cand e{dist2(pts[i], pts[j]), j, j};
+                            if (static_cast<int>(best.size()) < k) {
+                                best.push_back(e);
+                                std::push_heap(best.begin(), best.end());
+                            } else if (e < best.front()) {
+                                std::pop_heap(best.begin(), best.end());
+                                best.back() = e;
+                                std::push_heap(best.begin(), best.end());
+                            }
+                        }
+                    }
+                    if (ring == 0) break;
+                }
+            }
+        }
+        for (const Cand& e : best) out.push_back({e.d, std::min(i, e.a), std::max(i, e.a)});
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+struct DSU {
+    std::vector<int> parent, size;
+    explicit DSU(int n) : parent(n), size(n, 1) { for (int i = 0; i < n; ++i) parent[i] = i; }
+    int find(int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    }
+    bool unite(int a, int b) {
+        a = find(a); b = find(b);
+        if (a == b) return false;
+        if (size[a] < size[b]) std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        return true;
+    }
+};
+
 } // anonymous namespace
 
 // ------------------------------------------------------------
@@ -148,8 +278,77 @@ std::vector<Territory> build20(unsigned seed) {
     for (int i = 0; i < kN; ++i) {
         t[i].code = codes[i];
         t[i].name = std::string(1, codes[i]);
-        t[i].owner = PlayerId::None;
-        t[i].armies = 0;
+        t[i].r = pts[i].first;
+        t[i].c = pts[i].second;
+    }
+
+    // 5) fill adjacency
+    for (auto [a,b] : edges) {
+        t[a].adj.push_back(b);
+        t[b].adj.push_back(a);
+    }
+    return t;
+}
+
+std::string nameFor(int i) {
+    std::string s;
+    for (++i; i > 0; i = (i - 1) / 26) s.insert(s.begin(), static_cast<char>('A' + (i - 1) % 26));
+    return s;
+}
+
+std::vector<Territory> build(int n, unsigned seed) {
+    const double scale = std::sqrt(std::max(1.0, static_cast<double>(n) / kN));
+    return build(n, static_cast<int>(std::lround(kRows * scale)),
+                 static_cast<int>(std::lround(kCols * scale)), seed);
+}
+
+std::vector<Territory> build(int n, int rows, int cols, unsigned seed) {
+    rows = std::max(1, rows);
+    cols = std::max(1, cols);
+    n = std::clamp(n, 1, rows * cols);
+    Rng::Stream rng(seed);
+
+    // 1) positions
+    auto pts = placePointsGrid(n, rows, cols, rng);
+
+    // 2) spanning tree over nearest-neighbour candidates; widen k until
+    //    the candidate graph is connected (k = n - 1 is the full graph)
+    std::vector<Cand> cand;
+    std::vector<std::pair<int,int>> edges;
+    for (int k = std::min(8, n - 1); ; k = std::min(2 * k, n - 1)) {
+        cand = nearestCandidates(pts, rows, cols, k);
+        DSU dsu(n);
+        edges.clear();
+        for (const Cand& e : cand)
+            if (dsu.unite(e.a, e.b)) edges.emplace_back(e.a, e.b);
+        if (static_cast<int>(edges.size()) == n - 1 || k >= n - 1) break;
+    }
+
+    // 3) extra near-neighbour edges within the degree cap
+    std::vector<int> degree(n, 0);
+    std::unordered_set<std::uint64_t> present;
+    present.reserve(edges.size() * 2);
+    auto key = [](int a, int b) { return (static_cast<std::uint64_t>(a) << 32) | static_cast<std::uint32_t>(b); };
+    for (auto [a,b] : edges) {
+        ++degree[a]; ++degree[b];
+        present.insert(key(a, b));
+    }
+    const int extraTarget = n * kExtraEdgesTarget / kN;
+    int added = 0;
+    for (const Cand& e : cand) {
+        if (added >= extraTarget) break;
+        if (degree[e.a] >= kMaxDegree || degree[e.b] >= kMaxDegree) continue;
+        if (!present.insert(key(e.a, e.b)).second) continue;
+        edges.emplace_back(e.a, e.b);
+        ++degree[e.a]; ++degree[e.b];
+        ++added;
+    }
+
+    // 4) build Territory list
+    std::vector<Territory> t(n);
+    for (int i = 0; i < n; ++i) {
+        t[i].name = nameFor(i);
+        t[i].code = t[i].name.size() == 1 ? t[i].name[0] : kNoCode;
         t[i].r = pts[i].first;
         t[i].c = pts[i].second;
     }
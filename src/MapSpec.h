@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 #include <vector>
 #include "Types.h"
 
@@ -9,12 +10,32 @@
 // random coordinates with spacing and minimal spanning tree
 // connectivity, then adds limited extra edges for realism.
 //
+// build(n, …) does the same at any size in O(n log n): points
+// by Poisson-disk sampling on an occupancy grid, the spanning
+// tree by Kruskal over k-nearest-neighbour candidates found
+// through a bucket grid, and extra edges with O(1) edge/degree
+// checks. Territories are named A…Z, AA, AB, …; names of more
+// than one letter get the shared code kNoCode.
+//
 namespace MapSpec {
 
+    constexpr int kDefaultTerritories = 20;
+    constexpr char kNoCode = '#';
+
     // Build a 20-territory random map with a random seed.
     std::vector<Territory> build20();
 
     // Deterministic variant (for tests or reproducibility).
     std::vector<Territory> build20(unsigned seed);
 
+    // n territories on a rows × cols canvas (n is capped at the
+    // number of cells). Connected for any n ≥ 1; deterministic per seed.
+    std::vector<Territory> build(int n, int rows, int cols, unsigned seed);
+
+    // Same, on the 15 × 25 canvas scaled to keep build20's density.
+    std::vector<Territory> build(int n, unsigned seed);
+
+    // Spreadsheet-style label for territory i: A … Z, AA, AB, …
+    std::string nameFor(int i);
+
 } // namespace MapSpec
@@ -0,0 +1,67 @@
+#include "MapTopology.h"
+#include "MapSpec.h"
+#include <algorithm>
+#include <unordered_set>
+
+// ---------- Construction ----------
+MapTopology::MapTopology(const std::vector<Territory>& territories) {
+    const int n = static_cast<int>(territories.size());
+    codes_.reserve(n);
+    names_.reserve(n);
+    rows_.reserve(n);
+    cols_.reserve(n);
+    offsets_.assign(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        const auto& t = territories[i];
+        codes_.push_back(t.code);
+        names_.push_back(t.name);
+        rows_.push_back(t.r);
+        cols_.push_back(t.c);
+        offsets_[i + 1] = offsets_[i] + static_cast<int>(t.adj.size());
+    }
+    nbrs_.reserve(offsets_[n]);
+    for (const auto& t : territories) nbrs_.insert(nbrs_.end(), t.adj.begin(), t.adj.end());
+
+    hasMasks_ = (n <= TerrMask::kBits);
+    if (hasMasks_) {
+        allMask_ = TerrMask::firstN(n);
+        adjMask_.assign(n, TerrMask{});
+        for (int i = 0; i < n; ++i)
+            for (TerrId j : neighbors(i))
+                if (j >= 0 && j < n) adjMask_[i].set(j);
+    }
+}
+
+bool MapTopology::areAdjacent(TerrId a, TerrId b) const {
+    if (a < 0 || a >= count() || b < 0 || b >= count()) return false;
+    if (hasMasks_) return adjMask_[a].test(b);
+    const auto nb = neighbors(a);
+    return std::find(nb.begin(), nb.end(), b) != nb.end();
+}
+
+// ---------- Validators ----------
+bool MapTopology::validateAdjUndirected() const {
+    for (int a = 0; a < count(); ++a) {
+        for (TerrId b : neighbors(a)) {
+            if (b < 0 || b >= count()) return false;
+            const auto back = neighbors(b);
+            if (std::find(back.begin(), back.end(), a) == back.end()) return false;
+        }
+    }
+    return true;
+}
+
+bool MapTopology::validateUniqueCodesAndCoords() const {
+    std::unordered_set<char> codes;
+    std::unordered_set<std::string> names;
+    std::unordered_set<long long> coords;
+
+    for (int i = 0; i < count(); ++i) {
+        // Large maps share MapSpec::kNoCode; their names stay unique.
+        if (codes_[i] != MapSpec::kNoCode && !codes.insert(codes_[i]).second) return false;
+        if (!names_[i].empty() && !names.insert(names_[i]).second) return false;
+        if (!coords.insert((static_cast<long long>(rows_[i]) << 32) ^ static_cast<unsigned>(cols_[i])).second)
+            return false;
+    }
+    return true;
+}
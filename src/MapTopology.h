@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TerrMask.h"
+#include "Types.h"
+
+// ------------------------------------------------------------
+// MapTopology — the immutable part of a map
+//  • Codes, names, grid positions and adjacency, built once per
+//    map and shared read-only (shared_ptr<const>) by every Board
+//    and game played on it, across threads
+//  • Adjacency in CSR form: offsets + one flat neighbour array,
+//    so a neighbour walk is a contiguous scan
+//  • Adjacency bitboards for maps of at most TerrMask::kBits
+// ------------------------------------------------------------
+
+// Contiguous view of one territory's neighbours.
+struct NeighborRange {
+    const TerrId* first{nullptr};
+    const TerrId* last{nullptr};
+
+    const TerrId* begin() const { return first; }
+    const TerrId* end() const { return last; }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+    TerrId operator[](std::size_t i) const { return first[i]; }
+};
+
+class MapTopology {
+public:
+    explicit MapTopology(const std::vector<Territory>& territories);
+
+    static std::shared_ptr<const MapTopology> make(const std::vector<Territory>& territories) {
+        return std::make_shared<const MapTopology>(territories);
+    }
+
+    int count() const { return static_cast<int>(codes_.size()); }
+    char code(TerrId id) const { return codes_[id]; }
+    const std::string& name(TerrId id) const { return names_[id]; }
+    int row(TerrId id) const { return rows_[id]; }
+    int col(TerrId id) const { return cols_[id]; }
+
+    NeighborRange neighbors(TerrId id) const {
+        return {nbrs_.data() + offsets_[id], nbrs_.data() + offsets_[id + 1]};
+    }
+    int degree(TerrId id) const { return offsets_[id + 1] - offsets_[id]; }
+    bool areAdjacent(TerrId a, TerrId b) const;
+
+    bool hasMasks() const { return hasMasks_; }
+    const TerrMask& allMask() const { return allMask_; }
+    const TerrMask& adjMask(TerrId id) const { return adjMask_[id]; }
+
+    // --- Validators ---
+    bool validateAdjUndirected() const;
+    bool validateUniqueCodesAndCoords() const;
+
+private:
+    std::vector<char> codes_;
+    std::vector<std::string> names_;
+    std::vector<int> rows_, cols_;
+    std::vector<int> offsets_;               // count() + 1 entries
+    std::vector<TerrId> nbrs_;
+
+    bool hasMasks_{false};
+    TerrMask allMask_;
+    std::vector<TerrMask> adjMask_;
+};
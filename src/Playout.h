@@ -0,0 +1,75 @@
+#pragma once
+#include <algorithm>
+#include "BattleOdds.h"
+#include "Board.h"
+#include "Dice.h"
+#include "Instrument.h"
+#include "Rules.h"
+#include "Types.h"
+
+// ------------------------------------------------------------
+// Playout — the greedy turn shared by MCTS playouts and Eval rollouts
+// ------------------------------------------------------------
+// Templated on the dice source: anything with a
+// `std::uint32_t next32()`, one draw per round (Dice::attackerLosses).
+// MCTS passes its Rng::Stream; Eval passes antithetic dice. A round
+// is counted like Rules::applyBattle and uses its draws the same
+// way, so a Stream gives the same game either way.
+//
+namespace Playout {
+
+    constexpr int kMaxAttacks = 8;      // attacks per playout turn
+
+    // Fights from→to until capture or the attacker is down to one army.
+    template <class Dice>
+    bool fightOut(Board& b, TerrId from, TerrId to, PlayerId p, Dice& dice) {
+        while (b.armies(from) >= 2 && b.owner(to) != p) {
+            const int ad = Rules::attackerDice(b.armies(from));
+            const int dd = Rules::defenderDice(b.armies(to));
+            MR_COUNT(kBattles);
+            MR_COUNT(kDiceRounds);
+            const int lost = ::Dice::attackerLosses(ad, dd, dice.next32());
+            if (b.applyLosses(from, to, lost, std::min(ad, dd) - lost)) {
+                b.capture(to, p);
+                MR_COUNT(kCaptures);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Chain bonus, then the base reinforcement on the strongest
+    // frontier territory, then up to kMaxAttacks attacks while the
+    // exact capture odds are at least 50%, moving everything in.
+    template <class Dice>
+    void greedyTurn(Board& b, PlayerId p, Dice& dice) {
+        TerrId bonus = -1;
+        if (Rules::chainOf5BonusTarget(b, p, bonus)) b.addArmies(bonus, 5);
+        const int base = Rules::baseReinforcements(b, p);
+
+        TerrId where = -1;
+        for (TerrId t : b.frontier(p))
+            if (where < 0 || b.armies(t) > b.armies(where)) where = t;
+        if (where < 0) return;
+        b.addArmies(where, base);
+
+        for (int k = 0; k < kMaxAttacks; ++k) {
+            TerrId bf = -1, bt = -1;
+            double bestP = 0.5;
+            for (TerrId from : b.frontier(p)) {
+                if (b.armies(from) < 2) continue;
+                for (TerrId to : b.neighbors(from)) {
+                    if (b.owner(to) == p) continue;
+                    const double pr = BattleOdds::captureProb(b.armies(from), b.armies(to));
+                    if (pr >= bestP) { bestP = pr; bf = from; bt = to; }
+                }
+            }
+            if (bf < 0) return;
+            if (fightOut(b, bf, bt, p, dice)) {
+                Rules::moveAfterCapture(b, bf, bt, b.armies(bf) - 1);
+                if (b.status() != GameState::Ongoing) return;
+            }
+        }
+    }
+
+} // namespace Playout
@@ -1,63 +1,46 @@
 #include "RandomAI.h"
+#include "BattleOdds.h"
+#include "Instrument.h"
 #include "Rules.h"
 #include "Board.h"
+#include "Rng.h"
+#include "ThreadPool.h"
 #include <algorithm>
-#include <random>
+#include <tuple>
 #include <vector>
 
 namespace RandomAI {
 
+namespace {
+    // Candidates per pool chunk: scoring one is a table lookup, so only
+    // very large boards have enough of them to be worth fanning out.
+    constexpr std::size_t kParallelGrain = 256;
+
+    ThreadPool* poolFor(ThreadPool* pool, std::size_t candidates) {
+        return candidates >= 2 * kParallelGrain ? pool : nullptr;
+    }
+}
+
 // ---------- Reinforcement ----------
 TerrId chooseReinforcement(const Board& b, PlayerId p,
                            int /*reinforcements*/, std::uint32_t seed) {
+    MR_TIME_DECISION(kChooseReinforcement);
     auto ownedList = Rules::owned(b, p);
     if (ownedList.empty()) return -1;
 
-    std::mt19937 rng(seed);
-    std::uniform_int_distribution<int> dist(0, static_cast<int>(ownedList.size()) - 1);
-    return ownedList[dist(rng)];
+    Rng::Stream rng(seed);
+    return ownedList[rng.below(static_cast<std::uint32_t>(ownedList.size()))];
 }
 
 // ---------- Helpers ----------
-static bool simulateFullBattleOnce(int atkStart, int defStart, unsigned seed) {
-    std::mt19937 rng(seed);
-    int a = atkStart, d = defStart;
-    unsigned localSeed = seed;
-
-    while (a > 1 && d > 0) {
-        int aDice = Rules::attackerDice(a);
-        int dDice = Rules::defenderDice(d);
-        if (aDice <= 0 || dDice <= 0) break;
-
-        auto losses = Rules::simulateBattleOnce(aDice, dDice, localSeed++);
-        a -= losses.attacker;
-        d -= losses.defender;
-
-        if (a < 0) a = 0;
-        if (d < 0) d = 0;
-    }
-    return (d <= 0 && a > 0);
-}
-
-static double estimateCaptureProb(const Board& b, TerrId from, TerrId to,
-                                  int trials, std::uint32_t baseSeed) {
+static double captureProb(const Board& b, TerrId from, TerrId to) {
     if (from < 0 || to < 0) return 0.0;
-
-    int atk = b.at(from).armies;
-    int def = b.at(to).armies;
-    if (atk < 2) return 0.0;
-    if (def <= 0) return 1.0;
-
-    int wins = 0;
-    for (int t = 0; t < trials; ++t) {
-        unsigned s = baseSeed + static_cast<unsigned>(t * 7919 + from * 97 + to * 131);
-        if (simulateFullBattleOnce(atk, def, s)) ++wins;
-    }
-    return static_cast<double>(wins) / static_cast<double>(trials);
+    return BattleOdds::captureProb(b.armies(from), b.armies(to));
 }
 
 // ---------- Attack ----------
-AttackPlan chooseAttack(const Board& b, PlayerId p, std::uint32_t seed) {
+AttackPlan chooseAttack(const Board& b, PlayerId p, std::uint32_t /*seed*/, ThreadPool* pool) {
+    MR_TIME_DECISION(kChooseAttack);
     AttackPlan plan;
 
     auto borders = Rules::borders(b, p);
@@ -67,7 +50,7 @@ AttackPlan chooseAttack(const Board& b, PlayerId p, std::uint32_t seed) {
     std::vector<Pair> legalPairs;
 
     for (TerrId from : borders) {
-        if (b.at(from).armies < 2) continue;
+        if (b.armies(from) < 2) continue;
         for (TerrId to : b.neighbors(from))
             if (Rules::canAttack(b, from, to, p))
                 legalPairs.push_back({from, to});
@@ -75,18 +58,29 @@ AttackPlan chooseAttack(const Board& b, PlayerId p, std::uint32_t seed) {
 
     if (legalPairs.empty()) return plan;
 
-    const int trials = 80;
     const double minAccept = 0.40;
 
+    auto scoreOf = [&b](const Pair& pr) {
+        double prob = captureProb(b, pr.f, pr.t);
+        int diff = b.armies(pr.f) - b.armies(pr.t);
+        return prob + 0.001 * diff;
+    };
+
     double bestScore = -1.0;
     Pair best{-1, -1};
 
-    for (size_t i = 0; i < legalPairs.size(); ++i) {
-        const auto& pr = legalPairs[i];
-        double prob = estimateCaptureProb(b, pr.f, pr.t, trials, seed + static_cast<unsigned>(i * 31));
-        int diff = b.at(pr.f).armies - b.at(pr.t).armies;
-        double score = prob + 0.001 * diff;
-        if (score > bestScore) { bestScore = score; best = pr; }
+    // Scores are independent; the pick is always made in index order.
+    if (ThreadPool* fan = poolFor(pool, legalPairs.size())) {
+        std::vector<double> scores(legalPairs.size());
+        fan->parallelFor(legalPairs.size(),
+                          [&](size_t i) { scores[i] = scoreOf(legalPairs[i]); }, kParallelGrain);
+        for (size_t i = 0; i < legalPairs.size(); ++i)
+            if (scores[i] > bestScore) { bestScore = scores[i]; best = legalPairs[i]; }
+    } else {
+        for (const auto& pr : legalPairs) {
+            double score = scoreOf(pr);
+            if (score > bestScore) { bestScore = score; best = pr; }
+        }
     }
 
     if (bestScore < (minAccept - 0.001 * 1000)) return plan;
@@ -98,33 +92,47 @@ AttackPlan chooseAttack(const Board& b, PlayerId p, std::uint32_t seed) {
 }
 
 // ---------- Fortify ----------
-FortifyPlan chooseFortify(const Board& b, PlayerId p, std::uint32_t seed) {
+FortifyPlan chooseFortify(const Board& b, PlayerId p, std::uint32_t seed, ThreadPool* pool) {
+    MR_TIME_DECISION(kChooseFortify);
     FortifyPlan plan;
 
     auto ownedList = Rules::owned(b, p);
     if (ownedList.empty()) return plan;
 
-    std::mt19937 rng(seed);
+    Rng::Stream rng(seed);
     std::vector<std::tuple<TerrId, TerrId, int>> opts;
 
-    for (TerrId from : ownedList) {
-        if (b.at(from).armies < 2) continue;
-        for (TerrId to : b.neighbors(from)) {
-            if (Rules::canFortify(b, from, to, p)) {
-                int maxMove = b.at(from).armies - 1;
-                if (maxMove > 0) {
-                    std::uniform_int_distribution<int> amtDist(1, maxMove);
-                    int amt = amtDist(rng);
-                    opts.emplace_back(from, to, amt);
-                }
-            }
+    auto addOption = [&](TerrId from, TerrId to) {
+        int maxMove = b.armies(from) - 1;
+        if (maxMove > 0) {
+            int amt = 1 + static_cast<int>(rng.below(static_cast<std::uint32_t>(maxMove)));
+            opts.emplace_back(from, to, amt);
+        }
+    };
+
+    // Legality checks may fan out; amounts are drawn in enumeration order
+    // either way, so the rng stream (and the choice) is the same.
+    if (ThreadPool* fan = poolFor(pool, ownedList.size())) {
+        std::vector<std::vector<TerrId>> targets(ownedList.size());
+        fan->parallelFor(ownedList.size(), [&](size_t k) {
+            TerrId from = ownedList[k];
+            if (b.armies(from) < 2) return;
+            for (TerrId to : b.neighbors(from))
+                if (Rules::canFortify(b, from, to, p)) targets[k].push_back(to);
+        }, kParallelGrain);
+        for (size_t k = 0; k < ownedList.size(); ++k)
+            for (TerrId to : targets[k]) addOption(ownedList[k], to);
+    } else {
+        for (TerrId from : ownedList) {
+            if (b.armies(from) < 2) continue;
+            for (TerrId to : b.neighbors(from))
+                if (Rules::canFortify(b, from, to, p)) addOption(from, to);
         }
     }
 
     if (opts.empty()) return plan;
 
-    std::uniform_int_distribution<int> pick(0, static_cast<int>(opts.size()) - 1);
-    auto [f, t, amt] = opts[pick(rng)];
+    auto [f, t, amt] = opts[rng.below(static_cast<std::uint32_t>(opts.size()))];
     plan.from = f;
     plan.to = t;
     plan.amount = amt;
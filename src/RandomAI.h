@@ -3,6 +3,11 @@
 #include "Board.h"
 #include "Types.h"
 
+class ThreadPool;
+
+// chooseAttack / chooseFortify score large candidate sets on `pool`
+// when one is given (nullptr = serial). Choices never depend on the
+// pool or its size.
 namespace RandomAI {
 
     // ---------------- REINFORCEMENTS ----------------
@@ -20,7 +25,8 @@ namespace RandomAI {
 
     // Selects an attack (from→to). May skip attack (valid=false)
     // if probabilities are too low.
-    AttackPlan chooseAttack(const Board& b, PlayerId p, std::uint32_t seed);
+    AttackPlan chooseAttack(const Board& b, PlayerId p, std::uint32_t seed,
+                            ThreadPool* pool = nullptr);
 
     // ---------------- FORTIFY ----------------
     struct FortifyPlan {
@@ -32,6 +38,7 @@ namespace RandomAI {
 
     // Chooses a fortification move between adjacent owned territories.
     // Returns valid=false if AI chooses to skip.
-    FortifyPlan chooseFortify(const Board& b, PlayerId p, std::uint32_t seed);
+    FortifyPlan chooseFortify(const Board& b, PlayerId p, std::uint32_t seed,
+                              ThreadPool* pool = nullptr);
 
 } // namespace RandomAI
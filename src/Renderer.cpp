@@ -0,0 +1,168 @@
+#include "Renderer.h"
+#include "Rng.h"
+#include <algorithm>
+#include <unistd.h>
+
+namespace {
+    constexpr const char* kReset   = "\x1b[0m";
+    constexpr const char* kFgWhite = "\x1b[97m";
+    constexpr const char* kBgBlack = "\x1b[40m";
+    constexpr const char* kBgGrey  = "\x1b[100m";
+    constexpr const char* kBgBlue  = "\x1b[44m";
+    constexpr const char* kBgRed   = "\x1b[41m";
+}
+
+// ---------- Construction ----------
+BoardRenderer::BoardRenderer(int cellWidth) : cellWidth_(std::max(2, cellWidth)) {}
+
+// ---------- Layout ----------
+bool BoardRenderer::syncLayout(const Board& b) {
+    // Boards sharing one topology object skip the O(n) key entirely.
+    if (b.sharedTopology() == topo_ && !grid_.empty()) return false;
+    topo_ = b.sharedTopology();
+    const MapTopology* topo = topo_.get();
+    const int n = topo->count();
+    std::uint64_t key = Rng::mix64(static_cast<std::uint64_t>(n));
+    for (int i = 0; i < n; ++i)
+        key = Rng::hash(key, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(topo->row(i))) << 40) ^
+                             (static_cast<std::uint64_t>(static_cast<std::uint32_t>(topo->col(i))) << 8) ^
+                             static_cast<unsigned char>(topo->code(i)));
+    if (key == layoutKey_ && !grid_.empty()) return false;
+
+    layoutKey_ = key;
+    int maxR = 0, maxC = 0;
+    for (int i = 0; i < n; ++i) {
+        maxR = std::max(maxR, topo->row(i));
+        maxC = std::max(maxC, topo->col(i));
+    }
+    rows_ = maxR + 1;
+    cols_ = maxC + 1;
+    grid_.assign(static_cast<size_t>(rows_) * cols_, -1);
+    for (int i = 0; i < n; ++i) {
+        const int r = topo->row(i), c = topo->col(i);
+        if (r < 0 || c < 0) continue;
+        TerrId& slot = grid_[static_cast<size_t>(r) * cols_ + c];
+        if (slot < 0) slot = i;                 // first territory wins, as before
+    }
+    shown_.assign(n, Shown{});
+    shownValid_ = false;
+    return true;
+}
+
+void BoardRenderer::remember(const Board& b) {
+    for (int i = 0; i < b.count(); ++i) shown_[i] = {b.owner(i), b.armies(i)};
+    shownValid_ = true;
+}
+
+bool BoardRenderer::changed(const Board& b) {
+    if (syncLayout(b) || !shownValid_) return true;
+    for (int i = 0; i < b.count(); ++i)
+        if (shown_[i].owner != b.owner(i) || shown_[i].armies != b.armies(i)) return true;
+    return false;
+}
+
+// ---------- Cell formatting ----------
+void BoardRenderer::appendInt(int v) {
+    char digits[12];
+    int n = 0;
+    do { digits[n++] = static_cast<char>('0' + v % 10); v /= 10; } while (v > 0);
+    while (n > 0) buf_ += digits[--n];
+}
+
+void BoardRenderer::appendCell(const Board& b, TerrId id, bool armiesLine) {
+    const PlayerId o = id >= 0 ? b.owner(id) : PlayerId::None;
+    if (id < 0) buf_ += kBgBlack;
+    else if (o == PlayerId::P1) buf_ += kBgBlue;
+    else if (o == PlayerId::P2) buf_ += kBgRed;
+    else buf_ += kBgGrey;
+    buf_ += kFgWhite;
+
+    if (id < 0) {
+        buf_.append(cellWidth_, ' ');
+    } else if (!armiesLine) {
+        buf_ += b.code(id);
+        buf_.append(cellWidth_ - 1, ' ');
+    } else {
+        // Right-aligned, keeping the last cellWidth digits if too wide
+        char digits[12];
+        int n = 0;
+        int v = std::max(0, b.armies(id));
+        do { digits[n++] = static_cast<char>('0' + v % 10); v /= 10; } while (v > 0);
+        n = std::min(n, cellWidth_);
+        buf_.append(cellWidth_ - n, ' ');
+        while (n > 0) buf_ += digits[--n];
+    }
+    buf_ += kReset;
+}
+
+// ---------- Frames ----------
+const std::string& BoardRenderer::frame(const Board& b) {
+    syncLayout(b);
+    buf_.clear();
+    for (int r = 0; r < rows_; ++r) {
+        for (int line = 0; line < 2; ++line) {
+            for (int c = 0; c < cols_; ++c) {
+                appendCell(b, grid_[static_cast<size_t>(r) * cols_ + c], line == 1);
+            }
+            buf_ += '\n';
+        }
+    }
+    remember(b);
+    return buf_;
+}
+
+const std::string& BoardRenderer::update(const Board& b, int originRow) {
+    const bool full = syncLayout(b) || !shownValid_;
+    const MapTopology& topo = b.topology();
+    buf_.assign("\x1b" "7");                     // save cursor
+
+    auto moveTo = [&](int row, int col) {
+        buf_ += "\x1b[";
+        appendInt(row);
+        buf_ += ';';
+        appendInt(col);
+        buf_ += 'H';
+    };
+
+    if (full) {
+        for (int r = 0; r < rows_; ++r) {
+            for (int line = 0; line < 2; ++line) {
+                moveTo(originRow + 2 * r + line, 1);
+                for (int c = 0; c < cols_; ++c) {
+                    appendCell(b, grid_[static_cast<size_t>(r) * cols_ + c], line == 1);
+                }
+            }
+        }
+    } else {
+        for (int i = 0; i < b.count(); ++i) {
+            const Shown& s = shown_[i];
+            if (s.owner == b.owner(i) && s.armies == b.armies(i)) continue;
+            const int r = topo.row(i), c = topo.col(i);
+            if (r < 0 || c < 0 || grid_[static_cast<size_t>(r) * cols_ + c] != i) continue;   // not drawn
+            const int col = c * cellWidth_ + 1;
+            if (s.owner != b.owner(i)) {                // background of both lines
+                moveTo(originRow + 2 * r, col);
+                appendCell(b, i, false);
+            }
+            moveTo(originRow + 2 * r + 1, col);
+            appendCell(b, i, true);
+        }
+    }
+
+    remember(b);
+    if (buf_.size() == 2) buf_.clear();          // nothing changed
+    else buf_ += "\x1b" "8";                     // restore cursor
+    return buf_;
+}
+
+// ---------- Output ----------
+void BoardRenderer::present(const std::string& bytes, int fd) {
+    const char* p = bytes.data();
+    size_t left = bytes.size();
+    while (left > 0) {                          // one call unless interrupted
+        ssize_t n = ::write(fd, p, left);
+        if (n <= 0) return;
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+}
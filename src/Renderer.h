@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "Types.h"
+
+// ------------------------------------------------------------
+// BoardRenderer — colour board frames for a terminal
+//  • Builds the coordinate → territory grid once per map layout
+//    (re-checked only when the Board's topology object changes)
+//  • frame(): the whole board (same bytes as Board::renderColor)
+//  • update(): only the territories whose owner or armies changed
+//    since the last frame, as cursor-addressed cell rewrites
+//  • All output goes into one reusable buffer; present() hands it
+//    to the terminal in a single write()
+// ------------------------------------------------------------
+class BoardRenderer {
+public:
+    explicit BoardRenderer(int cellWidth = 3);
+
+    // Full frame at the current cursor position.
+    const std::string& frame(const Board& b);
+
+    // Changes since the previous frame()/update(), drawn in place
+    // relative to a board whose top-left cell sits at screen row
+    // `originRow` (1-based). Empty when nothing changed.
+    const std::string& update(const Board& b, int originRow = 1);
+
+    // True if b differs from the last frame drawn (or none was).
+    bool changed(const Board& b);
+
+    int cellWidth() const { return cellWidth_; }
+    int height() const { return 2 * rows_; }   // lines per frame (after a draw)
+    void invalidate() { shownValid_ = false; }  // next update() redraws all
+
+    static void present(const std::string& bytes, int fd = 1);
+
+private:
+    struct Shown {
+        PlayerId owner{PlayerId::None};
+        int armies{0};
+    };
+
+    bool syncLayout(const Board& b);            // true if the grid was rebuilt
+    void appendCell(const Board& b, TerrId id, bool armiesLine);   // id -1 = empty
+    void appendInt(int v);
+    void remember(const Board& b);
+
+    int cellWidth_;
+    int rows_{0}, cols_{0};
+    std::shared_ptr<const MapTopology> topo_;   // last topology seen (kept alive)
+    std::uint64_t layoutKey_{0};
+    std::vector<TerrId> grid_;                  // rows_ × cols_, -1 = empty
+    std::vector<Shown> shown_;                  // per territory, last drawn
+    bool shownValid_{false};
+    std::string buf_;
+};
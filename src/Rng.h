@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+// ------------------------------------------------------------
+// Rng — counter-based random streams
+// ------------------------------------------------------------
+// A stream is a (key, counter) pair and draw i is a pure hash of
+// (key, i): seeding costs one multiply-xorshift, there is no state
+// table, and split(id) derives an independent child stream (per
+// game, per turn, per battle round, per worker) without touching
+// the parent. Satisfies UniformRandomBitGenerator, so <random>
+// distributions accept it.
+//
+namespace Rng {
+
+    // Bijective 64-bit finalizer (SplitMix64 / Stafford variant 13)
+    constexpr std::uint64_t mix64(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Draw number `counter` of the stream with key `key`
+    constexpr std::uint64_t hash(std::uint64_t key, std::uint64_t counter) {
+        return mix64(key ^ mix64(counter + 0x9E3779B97F4A7C15ull));
+    }
+
+    class Stream {
+    public:
+        using result_type = std::uint64_t;
+
+        constexpr Stream() = default;
+        constexpr explicit Stream(std::uint64_t key, std::uint64_t counter = 0)
+            : key_(mix64(key)), ctr_(counter) {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()() { return hash(key_, ctr_++); }
+        std::uint32_t next32() { return static_cast<std::uint32_t>((*this)() >> 32); }
+
+        // Unbiased integer in [0, n) (Lemire's multiply-shift with rejection)
+        std::uint32_t below(std::uint32_t n) {
+            std::uint64_t m = static_cast<std::uint64_t>(next32()) * n;
+            std::uint32_t lo = static_cast<std::uint32_t>(m);
+            if (lo < n) {
+                std::uint32_t t = (0u - n) % n;
+                while (lo < t) {
+                    m = static_cast<std::uint64_t>(next32()) * n;
+                    lo = static_cast<std::uint32_t>(m);
+                }
+            }
+            return static_cast<std::uint32_t>(m >> 32);
+        }
+
+        // Independent child stream; the parent is left unchanged.
+        Stream split(std::uint64_t id) const {
+            Stream s;
+            s.key_ = hash(key_ ^ 0x5851F42D4C957F2Dull, id);
+            return s;
+        }
+
+        std::uint64_t counter() const { return ctr_; }
+        std::uint64_t key() const { return key_; }        // draw i is hash(key(), i)
+        void discard(std::uint64_t n) { ctr_ += n; }      // skip n draws
+
+    private:
+        std::uint64_t key_{0x9E3779B97F4A7C15ull};
+        std::uint64_t ctr_{0};
+    };
+
+} // namespace Rng
@@ -3,6 +3,7 @@
 #include <utility>
 #include "Types.h"
 #include "Board.h"
+#include "Rng.h"
 
 // Pure game logic (no I/O). Implements Risk-style mechanics.
 namespace Rules {
@@ -10,6 +11,12 @@ namespace Rules {
     // ---------- Ownership ----------
     std::vector<TerrId> owned(const Board& b, PlayerId p);
     std::vector<TerrId> borders(const Board& b, PlayerId p);
+    int ownedCount(const Board& b, PlayerId p);
+
+    // Bitboard form of borders(); requires b.hasMasks().
+    // borders()/borderMask()/ownedCount()/gameStatus() read the Board's
+    // incrementally tracked state and cost O(1) or O(result).
+    TerrMask borderMask(const Board& b, PlayerId p);
 
     // ---------- Game state / victory ----------
     GameState gameStatus(const Board& b);
@@ -19,12 +26,13 @@ namespace Rules {
 
     // Connected component bonus: if any cluster of ≥5 owned territories exists,
     // grant a +5 bonus to one of them (returns true and fills tIdx).
+    // The target is the smallest id of the largest cluster (Board's ComponentIndex).
     bool chainOf5BonusTarget(const Board& b, PlayerId p, TerrId& tIdx);
 
     // ---------- Legality ----------
     bool canAttack(const Board& b, TerrId from, TerrId to, PlayerId attacker);
     bool canFortify(const Board& b, TerrId from, TerrId to, PlayerId p);
-    bool canFortifyPath(const Board& b, TerrId from, TerrId to, PlayerId p);
+    bool canFortifyPath(const Board& b, TerrId from, TerrId to, PlayerId p);   // O(1)
 
     // ---------- Battle mechanics ----------
     int attackerDice(int armiesAtFrom);
@@ -33,13 +41,24 @@ namespace Rules {
     struct BattleLosses { int attacker; int defender; };
 
     // Rolls dice, compares, and returns losses (no mutation).
+    // Draws one value from the stream; the seed overload keys a fresh stream.
+    BattleLosses simulateBattleOnce(int attDice, int defDice, Rng::Stream& rng);
     BattleLosses simulateBattleOnce(int attDice, int defDice, unsigned seed);
 
     // ---------- State updates ----------
+    bool applyBattle(Board& b, TerrId from, TerrId to,
+                     PlayerId attacker, Rng::Stream& rng,
+                     BattleLosses* last = nullptr);
     bool applyBattle(Board& b, TerrId from, TerrId to,
                      PlayerId attacker, unsigned seed,
                      BattleLosses* last = nullptr);
 
+    // Fights the whole battle (applyBattle until capture or one attacker
+    // left) in one step with Blitz::resolve; `total` gets the summed losses.
+    bool applyBlitz(Board& b, TerrId from, TerrId to,
+                    PlayerId attacker, Rng::Stream& rng,
+                    BattleLosses* total = nullptr);
+
     void moveAfterCapture(Board& b, TerrId from, TerrId to, int armiesToMove);
 
 } // namespace Rules
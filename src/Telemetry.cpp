@@ -0,0 +1,437 @@
+#include "Telemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr char kMagic[4] = {'M', 'R', 'T', 'L'};
+    constexpr char kChunkMagic[4] = {'M', 'R', 'T', 'C'};
+    constexpr std::size_t kHeaderSize = 8;
+    constexpr std::size_t kChunkHeaderSize = 16;
+    constexpr int kMaxColumns = Telemetry::kTurnColumns;
+    static_assert(Telemetry::kGameColumns <= kMaxColumns, "Sink::Columns holds either table");
+
+    const char* const kGameNames[Telemetry::kGameColumns] = {
+        "game", "result", "turns", "battles", "rounds", "attacker losses",
+        "defender losses", "captures", "reinforcements", "bonuses", "final stale",
+        "territories P1", "territories P2", "armies P1", "armies P2"};
+    const char* const kTurnNames[Telemetry::kTurnColumns] = {
+        "game", "turn", "player", "battles", "rounds", "attacker losses",
+        "defender losses", "captures", "reinforcements", "bonus", "stale",
+        "territories P1", "territories P2", "armies P1", "armies P2"};
+
+    std::uint64_t readFixed(const std::uint8_t* p, int bytes) {
+        std::uint64_t v = 0;
+        for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+        return v;
+    }
+
+    void putFixed(std::vector<std::uint8_t>& out, std::uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+    }
+
+    void patchFixed(std::vector<std::uint8_t>& out, std::size_t at, std::uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i) out[at + i] = static_cast<std::uint8_t>(v >> (8 * i));
+    }
+
+    void putVar(std::vector<std::uint8_t>& out, std::uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    std::uint64_t zigzag(std::int64_t v) {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t v) {
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+}
+
+// ------------------------------------------------------------
+namespace Telemetry {
+
+int columnCount(Table t) {
+    return t == Table::Games ? static_cast<int>(kGameColumns) : static_cast<int>(kTurnColumns);
+}
+
+const char* columnName(Table t, int column) {
+    if (column < 0 || column >= columnCount(t)) return "";
+    return t == Table::Games ? kGameNames[column] : kTurnNames[column];
+}
+
+// ============================================================
+// GameLog
+// ============================================================
+void GameLog::begin() {
+    game_ = GameRow{};
+    turns_.clear();
+    open_ = false;
+    stale_ = 0;
+    lastFrom_ = lastTo_ = -1;
+}
+
+void GameLog::turn(int turn, PlayerId p, const Board& b) {
+    if (open_) closeTurn(b);
+    TurnRow row{};
+    row[kTurn] = turn;
+    row[kPlayer] = static_cast<int>(p) + 1;
+    turns_.push_back(row);
+    open_ = true;
+    lastFrom_ = lastTo_ = -1;
+}
+
+void GameLog::bonus(int amount) {
+    if (!open_) return;
+    turns_.back()[kBonus] = 1;
+    turns_.back()[kReinforcements] += amount;
+}
+
+void GameLog::reinforce(int amount) {
+    if (open_) turns_.back()[kReinforcements] += amount;
+}
+
+void GameLog::battle(TerrId from, TerrId to, int rounds, int attackerLoss, int defenderLoss,
+                     bool captured) {
+    if (!open_) return;
+    TurnRow& row = turns_.back();
+    if (from != lastFrom_ || to != lastTo_) ++row[kBattles];
+    row[kRounds] += rounds;
+    row[kAttackerLosses] += attackerLoss;
+    row[kDefenderLosses] += defenderLoss;
+    if (captured) {
+        ++row[kCaptures];
+        lastFrom_ = lastTo_ = -1;
+    } else {
+        lastFrom_ = from;
+        lastTo_ = to;
+    }
+}
+
+void GameLog::closeTurn(const Board& b) {
+    TurnRow& row = turns_.back();
+    stale_ = row[kCaptures] ? 0 : stale_ + 1;
+    row[kStale] = stale_;
+    row[kTerritories1] = b.ownedCount(PlayerId::P1);
+    row[kTerritories2] = b.ownedCount(PlayerId::P2);
+    row[kArmies1] = b.armyTotal(PlayerId::P1);
+    row[kArmies2] = b.armyTotal(PlayerId::P2);
+
+    game_[kGameBattles] += row[kBattles];
+    game_[kGameRounds] += row[kRounds];
+    game_[kGameAttackerLosses] += row[kAttackerLosses];
+    game_[kGameDefenderLosses] += row[kDefenderLosses];
+    game_[kGameCaptures] += row[kCaptures];
+    game_[kGameReinforcements] += row[kReinforcements];
+    game_[kBonuses] += row[kBonus];
+    open_ = false;
+}
+
+void GameLog::finish(GameState status, int turns, const Board& b) {
+    if (open_) closeTurn(b);
+    game_[kResult] = static_cast<int>(status);
+    game_[kTurns] = turns;
+    game_[kFinalStale] = stale_;
+    game_[kGameTerritories1] = b.ownedCount(PlayerId::P1);
+    game_[kGameTerritories2] = b.ownedCount(PlayerId::P2);
+    game_[kGameArmies1] = b.armyTotal(PlayerId::P1);
+    game_[kGameArmies2] = b.armyTotal(PlayerId::P2);
+}
+
+// ============================================================
+// Sink
+// ============================================================
+Sink::Sink(const std::string& path) {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) == 0 && st.st_size > 0) {
+        // Append, after cutting whatever a crash left half-written.
+        std::size_t good = 0;
+        {
+            Reader r;
+            if (!r.open(path)) return;                  // not ours: leave it alone
+            good = r.goodBytes();
+            // Turns chunks fill up first, so after a crash a game's
+            // turns can be on disk without its game row.
+            r.forEach([&](const Chunk& ch) {
+                const int key = ch.table == Table::Games ? static_cast<int>(kGameId)
+                                                        : static_cast<int>(kTurnGame);
+                for (std::int64_t id : ch.column(key))
+                    first_ = std::max(first_, static_cast<std::uint64_t>(id) + 1);
+            });
+        }
+        if (good < static_cast<std::size_t>(st.st_size) &&
+            ::truncate(path.c_str(), static_cast<off_t>(good)) != 0)
+            return;
+        file_ = std::fopen(path.c_str(), "ab");
+    } else {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (file_) {
+            std::vector<std::uint8_t> h(kMagic, kMagic + 4);
+            putFixed(h, kVersion, 4);
+            if (std::fwrite(h.data(), 1, h.size(), file_) != h.size()) {
+                std::fclose(file_);
+                file_ = nullptr;
+            }
+        }
+    }
+    for (auto& v : games_.values) v.reserve(kChunkRows);
+    for (auto& v : turns_.values) v.reserve(kChunkRows);
+}
+
+Sink::~Sink() {
+    flush();
+    if (file_) std::fclose(file_);
+}
+
+void Sink::add(std::uint64_t game, const GameLog& log) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (game > next_) {
+        held_.emplace(game, log);
+        return;
+    }
+    write(game, log);
+    if (game == next_) ++next_;
+    for (auto it = held_.begin(); it != held_.end() && it->first == next_; it = held_.erase(it)) {
+        write(it->first, it->second);
+        ++next_;
+    }
+}
+
+std::size_t Sink::bufferedRows() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    std::size_t n = games_.rows + turns_.rows;
+    for (const auto& held : held_) n += 1 + held.second.turns().size();
+    return n;
+}
+
+void Sink::flush() {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (const auto& [game, log] : held_) {
+        write(game, log);
+        next_ = game + 1;
+    }
+    held_.clear();
+    if (games_.rows) writeChunk(Table::Games);
+    if (turns_.rows) writeChunk(Table::Turns);
+    if (file_) std::fflush(file_);
+}
+
+void Sink::write(std::uint64_t game, const GameLog& log) {
+    GameRow g = log.game();
+    g[kGameId] = static_cast<std::int64_t>(first_ + game);
+    append(Table::Games, g);
+    for (TurnRow t : log.turns()) {
+        t[kTurnGame] = static_cast<std::int64_t>(first_ + game);
+        append(Table::Turns, t);
+    }
+}
+
+template <std::size_t N>
+void Sink::append(Table t, const std::array<std::int64_t, N>& row) {
+    Columns& cols = t == Table::Games ? games_ : turns_;
+    for (std::size_t c = 0; c < N; ++c) cols.values[c].push_back(row[c]);
+    if (++cols.rows == kChunkRows) writeChunk(t);
+}
+
+void Sink::writeChunk(Table t) {
+    Columns& cols = t == Table::Games ? games_ : turns_;
+    const int n = columnCount(t);
+    buf_.clear();
+    for (char ch : kChunkMagic) buf_.push_back(static_cast<std::uint8_t>(ch));
+    buf_.push_back(static_cast<std::uint8_t>(t));
+    buf_.push_back(static_cast<std::uint8_t>(n));
+    putFixed(buf_, 0, 2);
+    putFixed(buf_, cols.rows, 4);
+    putFixed(buf_, 0, 4);                               // payload bytes, patched below
+    for (int c = 0; c < n; ++c) {
+        const std::size_t at = buf_.size();
+        putFixed(buf_, 0, 4);
+        std::int64_t prev = 0;
+        for (std::int64_t v : cols.values[c]) {
+            putVar(buf_, zigzag(v - prev));
+            prev = v;
+        }
+        patchFixed(buf_, at, buf_.size() - at - 4, 4);
+        cols.values[c].clear();
+    }
+    patchFixed(buf_, 12, buf_.size() - kChunkHeaderSize, 4);
+    cols.rows = 0;
+
+    if (file_ && std::fwrite(buf_.data(), 1, buf_.size(), file_) != buf_.size()) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+// ============================================================
+// Reader
+// ============================================================
+Reader::~Reader() { close(); }
+
+void Reader::close() {
+    if (data_) munmap(const_cast<std::uint8_t*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool Reader::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kHeaderSize)) {
+        ::close(fd);
+        return false;
+    }
+    void* m = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (m == MAP_FAILED) return false;
+    data_ = static_cast<const std::uint8_t*>(m);
+    size_ = static_cast<std::size_t>(st.st_size);
+    madvise(m, size_, MADV_SEQUENTIAL);
+
+    if (std::memcmp(data_, kMagic, 4) != 0 || readFixed(data_ + 4, 4) != kVersion) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool Reader::forEach(const std::function<void(const Chunk&)>& fn) const {
+    std::size_t end = 0;
+    return scan(&fn, end);
+}
+
+std::size_t Reader::goodBytes() const {
+    std::size_t end = 0;
+    scan(nullptr, end);
+    return end;
+}
+
+bool Reader::scan(const std::function<void(const Chunk&)>* fn, std::size_t& end) const {
+    std::vector<std::int64_t> cols[kMaxColumns];
+    std::size_t off = kHeaderSize;
+    end = data_ ? off : 0;
+    if (!data_) return false;
+
+    while (off + kChunkHeaderSize <= size_) {
+        const std::uint8_t* h = data_ + off;
+        if (std::memcmp(h, kChunkMagic, 4) != 0) return false;
+        const Table table = static_cast<Table>(h[4]);
+        if (table != Table::Games && table != Table::Turns) return false;
+        const int n = h[5];
+        const std::size_t rows = readFixed(h + 8, 4);
+        const std::size_t payload = readFixed(h + 12, 4);
+        if (n != columnCount(table) || payload > size_ - off - kChunkHeaderSize) return false;
+
+        // Each column must hold exactly `rows` values and the columns
+        // must fill the payload.
+        const std::uint8_t* p = h + kChunkHeaderSize;
+        const std::uint8_t* const stop = p + payload;
+        for (int c = 0; c < n; ++c) {
+            if (stop - p < 4) return false;
+            const std::size_t bytes = readFixed(p, 4);
+            p += 4;
+            if (bytes > static_cast<std::size_t>(stop - p)) return false;
+            const std::uint8_t* q = p;
+            const std::uint8_t* const colEnd = p + bytes;
+            if (fn) {
+                cols[c].clear();
+                std::int64_t prev = 0;
+                while (q < colEnd) {
+                    std::uint64_t v = 0;
+                    int shift = 0;
+                    while (q < colEnd && (*q & 0x80) && shift < 63) {
+                        v |= static_cast<std::uint64_t>(*q++ & 0x7f) << shift;
+                        shift += 7;
+                    }
+                    if (q == colEnd) return false;
+                    v |= static_cast<std::uint64_t>(*q++) << shift;
+                    prev += unzigzag(v);
+                    cols[c].push_back(prev);
+                }
+                if (cols[c].size() != rows) return false;
+            }
+            p = colEnd;
+        }
+        if (p != stop) return false;
+
+        if (fn) (*fn)(Chunk{table, rows, cols});
+        off = static_cast<std::size_t>(stop - data_);
+        end = off;
+    }
+    return off == size_;
+}
+
+// ============================================================
+// Quantile
+// ============================================================
+Quantile::Quantile(double p) : p_(std::clamp(p, 0.0, 1.0)) {
+    want_[0] = 1;
+    want_[1] = 1 + 2 * p_;
+    want_[2] = 1 + 4 * p_;
+    want_[3] = 3 + 2 * p_;
+    want_[4] = 5;
+    step_[0] = 0;
+    step_[1] = p_ / 2;
+    step_[2] = p_;
+    step_[3] = (1 + p_) / 2;
+    step_[4] = 1;
+}
+
+void Quantile::add(double x) {
+    if (n_ < 5) {
+        q_[n_++] = x;
+        if (n_ == 5) std::sort(q_, q_ + 5);
+        return;
+    }
+    ++n_;
+
+    // The cell x falls in; the outer markers track min and max.
+    int k;
+    if (x < q_[0]) { q_[0] = x; k = 0; }
+    else if (x >= q_[4]) { q_[4] = x; k = 3; }
+    else { k = 0; while (x >= q_[k + 1]) ++k; }
+    for (int i = k + 1; i < 5; ++i) pos_[i] += 1;
+    for (int i = 0; i < 5; ++i) want_[i] += step_[i];
+
+    // Middle markers drift toward their desired positions.
+    for (int i = 1; i <= 3; ++i) {
+        const double d = want_[i] - pos_[i];
+        if ((d >= 1 && pos_[i + 1] - pos_[i] > 1) || (d <= -1 && pos_[i - 1] - pos_[i] < -1)) {
+            const double s = d > 0 ? 1.0 : -1.0;
+            const double q = parabolic(i, s);
+            q_[i] = (q_[i - 1] < q && q < q_[i + 1]) ? q : linear(i, s);
+            pos_[i] += s;
+        }
+    }
+}
+
+double Quantile::parabolic(int i, double d) const {
+    return q_[i] + d / (pos_[i + 1] - pos_[i - 1]) *
+           ((pos_[i] - pos_[i - 1] + d) * (q_[i + 1] - q_[i]) / (pos_[i + 1] - pos_[i]) +
+            (pos_[i + 1] - pos_[i] - d) * (q_[i] - q_[i - 1]) / (pos_[i] - pos_[i - 1]));
+}
+
+double Quantile::linear(int i, double d) const {
+    const int j = i + static_cast<int>(d);
+    return q_[i] + d * (q_[j] - q_[i]) / (pos_[j] - pos_[i]);
+}
+
+double Quantile::value() const {
+    if (n_ == 0) return 0.0;
+    if (n_ >= 5) return q_[2];
+    double v[5];
+    std::copy(q_, q_ + n_, v);
+    std::sort(v, v + n_);
+    return v[static_cast<std::size_t>(std::lround(p_ * static_cast<double>(n_ - 1)))];
+}
+
+} // namespace Telemetry
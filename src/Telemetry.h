@@ -0,0 +1,197 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "Types.h"
+
+// ------------------------------------------------------------
+// Telemetry — per-game and per-turn statistics, column by column
+// ------------------------------------------------------------
+// A Game with a GameLog attached (Game::setTelemetry) fills one row
+// per turn and one per game. A Sink appends finished logs to a file,
+// and any number of games and runs can share that file:
+//   header   "MRTL" u32 version                      (8 bytes)
+//   chunk    "MRTC" u8 table, u8 columns, u16 0, u32 rows,
+//            u32 payload bytes                       (16 bytes)
+//            then per column: u32 bytes, and the column's values as
+//            zigzag LEB128 deltas from the previous row
+// Fixed-width fields are little-endian. A chunk holds up to
+// kChunkRows rows of one table, and the Sink writes it in one go.
+// Reading a column never touches the others, and the deltas keep
+// slowly changing columns (game, turn, counts) near one byte per
+// value. The Reader stops at the first damaged chunk, so after a
+// crash the file is good up to its last whole chunk. A new Sink
+// cuts a damaged tail before it appends, and numbers its games on
+// from the file's last game id (in either table).
+//
+// Column meanings:
+//  • battles: attacks on a new target (the same from → to again,
+//    right after a round that took nothing, continues a battle)
+//  • rounds: dice rounds rolled one at a time (Rules::applyBattle);
+//    blitz battles are sampled whole and add none, but their
+//    losses are counted
+//  • reinforcements: armies placed, the chain bonus included
+//  • stale: turns since the last capture, as Game counts toward
+//    kMaxStale, at the end of the turn
+//  • territories / armies: per player at the end of the turn (turn
+//    rows) or of the game (game rows)
+//
+namespace Telemetry {
+
+    constexpr std::uint32_t kVersion = 1;
+    constexpr std::size_t kChunkRows = 4096;
+
+    enum class Table : std::uint8_t { Games = 1, Turns = 2 };
+
+    enum GameColumn {
+        kGameId, kResult, kTurns, kGameBattles, kGameRounds, kGameAttackerLosses,
+        kGameDefenderLosses, kGameCaptures, kGameReinforcements, kBonuses, kFinalStale,
+        kGameTerritories1, kGameTerritories2, kGameArmies1, kGameArmies2,
+        kGameColumns
+    };
+
+    enum TurnColumn {
+        kTurnGame, kTurn, kPlayer, kBattles, kRounds, kAttackerLosses, kDefenderLosses,
+        kCaptures, kReinforcements, kBonus, kStale, kTerritories1, kTerritories2,
+        kArmies1, kArmies2,
+        kTurnColumns
+    };
+
+    int columnCount(Table t);
+    const char* columnName(Table t, int column);    // e.g. "battles"
+
+    using GameRow = std::array<std::int64_t, kGameColumns>;
+    using TurnRow = std::array<std::int64_t, kTurnColumns>;
+
+    // ---------- Collector (one per game) ----------
+    class GameLog {
+    public:
+        // Called by Game, in this order (bonus / reinforce / battle any
+        // number of times per turn).
+        void begin();
+        void turn(int turn, PlayerId p, const Board& b);
+        void bonus(int amount);
+        void reinforce(int amount);
+        void battle(TerrId from, TerrId to, int rounds, int attackerLoss, int defenderLoss,
+                    bool captured);
+        void finish(GameState status, int turns, const Board& b);
+
+        const GameRow& game() const { return game_; }
+        const std::vector<TurnRow>& turns() const { return turns_; }
+
+    private:
+        void closeTurn(const Board& b);
+
+        GameRow game_{};
+        std::vector<TurnRow> turns_;
+        bool open_{false};                      // turns_.back() still being filled
+        int stale_{0};
+        TerrId lastFrom_{-1}, lastTo_{-1};      // a battle that may continue
+    };
+
+    // ---------- Writer ----------
+    // Thread-safe. add() takes the run's own game numbers, from 0;
+    // they are written as firstGame() + game, so appended runs never
+    // reuse an id. Games reach the file in game order whatever order
+    // they finish in, so a run gives the same file for any thread
+    // count.
+    class Sink {
+    public:
+        explicit Sink(const std::string& path);
+        ~Sink();                                // writes everything held
+
+        Sink(const Sink&) = delete;
+        Sink& operator=(const Sink&) = delete;
+
+        bool ok() const { return file_ != nullptr; }
+        std::uint64_t firstGame() const { return first_; }
+        std::size_t bufferedRows() const;       // not yet in the file, held games included
+
+        void add(std::uint64_t game, const GameLog& log);
+        void flush();                           // partial chunks too; gaps are skipped
+
+    private:
+        struct Columns {
+            std::vector<std::int64_t> values[kTurnColumns];
+            std::size_t rows{0};
+        };
+
+        void write(std::uint64_t game, const GameLog& log);
+        template <std::size_t N>
+        void append(Table t, const std::array<std::int64_t, N>& row);
+        void writeChunk(Table t);
+
+        mutable std::mutex mu_;
+        std::FILE* file_{nullptr};
+        Columns games_, turns_;
+        std::vector<std::uint8_t> buf_;
+        std::uint64_t first_{0};                // id of the run's game 0
+        std::uint64_t next_{0};                 // next game to write (run numbering)
+        std::map<std::uint64_t, GameLog> held_; // finished early
+    };
+
+    // ---------- Reader ----------
+    struct Chunk {
+        Table table;
+        std::size_t rows;
+        const std::vector<std::int64_t>* columns;   // columnCount(table) of them
+
+        const std::vector<std::int64_t>& column(int c) const { return columns[c]; }
+    };
+
+    class Reader {
+    public:
+        Reader() = default;
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        bool open(const std::string& path);   // mmap; false if not a telemetry file
+        void close();
+
+        // Every chunk in file order, decoded one at a time. Returns
+        // false if it stopped at a damaged chunk (see goodBytes()).
+        bool forEach(const std::function<void(const Chunk&)>& fn) const;
+
+        std::size_t size() const { return size_; }
+        std::size_t goodBytes() const;        // up to the end of the last whole chunk
+
+    private:
+        bool scan(const std::function<void(const Chunk&)>* fn, std::size_t& end) const;
+
+        const std::uint8_t* data_{nullptr};
+        std::size_t size_{0};
+    };
+
+    // ---------- Streaming quantile ----------
+    // The P² estimator (Jain & Chlamtac, 1985): five markers, O(1)
+    // memory and time per value, exact for the first five values.
+    class Quantile {
+    public:
+        explicit Quantile(double p);
+
+        void add(double x);
+        double value() const;
+        std::uint64_t count() const { return n_; }
+
+    private:
+        double parabolic(int i, double d) const;
+        double linear(int i, double d) const;
+
+        double p_;
+        std::uint64_t n_{0};
+        double q_[5]{};                       // marker heights
+        double pos_[5]{1, 2, 3, 4, 5};        // actual positions
+        double want_[5]{};                    // desired positions
+        double step_[5]{};                    // their increments
+    };
+
+} // namespace Telemetry
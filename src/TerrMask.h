@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include "Types.h"
+
+// ------------------------------------------------------------
+// TerrMask — fixed 128-bit territory set (bitboard)
+// ------------------------------------------------------------
+// Bit i is territory i. Boards with at most kBits territories keep
+// per-player ownership masks and per-territory adjacency masks, so
+// set queries become a few word operations and a popcount.
+//
+struct TerrMask {
+    static constexpr int kBits = 128;
+
+    std::uint64_t w[2]{0, 0};
+
+    static TerrMask firstN(int n) {
+        TerrMask m;
+        if (n >= 64) { m.w[0] = ~0ull; n -= 64; m.w[1] = (n >= 64) ? ~0ull : ((1ull << n) - 1); }
+        else         { m.w[0] = (1ull << n) - 1; }
+        return m;
+    }
+
+    bool test(TerrId i) const  { return (w[i >> 6] >> (i & 63)) & 1u; }
+    void set(TerrId i)         { w[i >> 6] |= (1ull << (i & 63)); }
+    void reset(TerrId i)       { w[i >> 6] &= ~(1ull << (i & 63)); }
+
+    bool any() const  { return (w[0] | w[1]) != 0; }
+    bool none() const { return !any(); }
+    int count() const { return __builtin_popcountll(w[0]) + __builtin_popcountll(w[1]); }
+
+    TerrMask& operator&=(const TerrMask& o) { w[0] &= o.w[0]; w[1] &= o.w[1]; return *this; }
+    TerrMask& operator|=(const TerrMask& o) { w[0] |= o.w[0]; w[1] |= o.w[1]; return *this; }
+    TerrMask operator&(const TerrMask& o) const { TerrMask m = *this; return m &= o; }
+    TerrMask operator|(const TerrMask& o) const { TerrMask m = *this; return m |= o; }
+    TerrMask operator~() const { TerrMask m; m.w[0] = ~w[0]; m.w[1] = ~w[1]; return m; }
+    bool operator==(const TerrMask& o) const { return w[0] == o.w[0] && w[1] == o.w[1]; }
+    bool operator!=(const TerrMask& o) const { return !(*this == o); }
+
+    // Calls f(TerrId) for every set bit in ascending order.
+    template <class F>
+    void forEach(F f) const {
+        for (int k = 0; k < 2; ++k)
+            for (std::uint64_t x = w[k]; x; x &= x - 1)
+                f(static_cast<TerrId>(k * 64 + __builtin_ctzll(x)));
+    }
+};
@@ -0,0 +1,139 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+    // Identifies the pool/worker running on this thread (for local submits).
+    thread_local const ThreadPool* tlsPool = nullptr;
+    thread_local unsigned tlsIndex = 0;
+}
+
+// ---------- Construction ----------
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    queues_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i]{ workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stop_ = true;
+    }
+    wakeCv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+// ---------- Scheduling ----------
+void ThreadPool::submit(Task task) {
+    unsigned idx = (tlsPool == this)
+        ? tlsIndex
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % size();
+
+    // Counted before it is published: a worker may pop and run it (and
+    // decrement queued_) before this thread gets past the push.
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        ++queued_;
+    }
+    {
+        std::lock_guard<std::mutex> lk(queues_[idx]->m);
+        queues_[idx]->tasks.push_back(std::move(task));
+    }
+    wakeCv_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lk(m_);
+    doneCv_.wait(lk, [this]{ return pending_.load() == 0; });
+}
+
+// Helpers that start after the range is used up claim nothing, so they
+// never touch `body` once the caller has returned.
+void ThreadPool::parallelFor(std::size_t n, const std::function<void(std::size_t)>& body,
+                             std::size_t grain) {
+    if (n == 0) return;
+    grain = std::max<std::size_t>(1, grain);
+    const std::size_t chunks = (n + grain - 1) / grain;
+
+    struct Range {
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::mutex m;
+        std::condition_variable cv;
+    };
+    auto range = std::make_shared<Range>();
+    const auto* fn = &body;
+
+    auto drain = [range, fn, n, grain, chunks]{
+        std::size_t ran = 0;
+        for (std::size_t c; (c = range->next.fetch_add(1)) < chunks; ++ran) {
+            const std::size_t end = std::min(n, (c + 1) * grain);
+            for (std::size_t i = c * grain; i < end; ++i) (*fn)(i);
+        }
+        if (ran && range->done.fetch_add(ran) + ran == chunks) {
+            std::lock_guard<std::mutex> lk(range->m);
+            range->cv.notify_all();
+        }
+    };
+
+    const std::size_t helpers = std::min<std::size_t>(size(), chunks - 1);
+    for (std::size_t h = 0; h < helpers; ++h) submit(drain);
+    drain();
+
+    std::unique_lock<std::mutex> lk(range->m);
+    range->cv.wait(lk, [&]{ return range->done.load() == chunks; });
+}
+
+bool ThreadPool::tryPop(unsigned idx, Task& out) {
+    // Own deque first (newest task, warm cache) ...
+    {
+        auto& q = *queues_[idx];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (!q.tasks.empty()) {
+            out = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            return true;
+        }
+    }
+    // ... then steal the oldest task from a victim.
+    const unsigned n = size();
+    for (unsigned k = 1; k < n; ++k) {
+        auto& q = *queues_[(idx + k) % n];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (!q.tasks.empty()) {
+            out = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned idx) {
+    tlsPool = this;
+    tlsIndex = idx;
+
+    for (;;) {
+        Task task;
+        if (tryPop(idx, task)) {
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                --queued_;
+            }
+            task();
+            if (pending_.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lk(m_);
+                doneCv_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(m_);
+        wakeCv_.wait(lk, [this]{ return stop_ || queued_ > 0; });
+        if (stop_ && queued_ == 0) return;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ------------------------------------------------------------
+// ThreadPool — fixed set of workers with work stealing
+//  • Each worker owns a deque: it pops its own tasks LIFO and
+//    steals from the other deques FIFO when it runs dry
+//  • Tasks submitted from a worker go to that worker's deque
+//  • parallelFor splits an index range across the workers and the
+//    calling thread; it may be called from inside a task
+// ------------------------------------------------------------
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned threads = 0);   // 0 = hardware_concurrency
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+    void wait();                                 // until every task has finished
+
+    // Runs body(i) for i in [0, n), in chunks of `grain` indices. The
+    // caller takes chunks too and returns once all n have run. Chunks
+    // are claimed in any order, so body must not depend on which thread
+    // runs it (derive randomness from i, e.g. Rng::Stream::split(i)) and
+    // must not throw.
+    void parallelFor(std::size_t n, const std::function<void(std::size_t)>& body,
+                     std::size_t grain = 1);
+    unsigned size() const { return static_cast<unsigned>(queues_.size()); }   // fixed before workers start
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned idx);
+    bool tryPop(unsigned idx, Task& out);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex m_;
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+    std::size_t queued_{0};                      // guarded by m_
+    std::atomic<std::size_t> pending_{0};        // queued + running
+    std::atomic<unsigned> nextQueue_{0};
+    bool stop_{false};
+};
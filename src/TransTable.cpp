@@ -0,0 +1,56 @@
+#include "TransTable.h"
+#include <algorithm>
+#include <cstring>
+
+// ---------- Construction ----------
+TransTable::TransTable(int log2Slots)
+    : slots_(new Slot[std::size_t{1} << std::clamp(log2Slots, 1, 30)]),
+      mask_((std::size_t{1} << std::clamp(log2Slots, 1, 30)) - 1) {}
+
+void TransTable::clear() {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+        slots_[i].check.store(0, std::memory_order_relaxed);
+        slots_[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+// ---------- Packing ----------
+std::uint64_t TransTable::pack(const Entry& e) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &e.mean, sizeof bits);
+    return (static_cast<std::uint64_t>(e.count) << 32) | bits;
+}
+
+TransTable::Entry TransTable::unpack(std::uint64_t d) {
+    Entry e;
+    e.count = static_cast<std::uint32_t>(d >> 32);
+    std::uint32_t bits = static_cast<std::uint32_t>(d);
+    std::memcpy(&e.mean, &bits, sizeof bits);
+    return e;
+}
+
+// ---------- Access ----------
+bool TransTable::probe(std::uint64_t key, Entry& out) const {
+    const Slot& s = slots_[key & mask_];
+    const std::uint64_t data = s.data.load(std::memory_order_relaxed);
+    const std::uint64_t check = s.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || data == 0) return false;
+    out = unpack(data);
+    return true;
+}
+
+void TransTable::store(std::uint64_t key, const Entry& e) {
+    Slot& s = slots_[key & mask_];
+    const std::uint64_t data = pack(e);
+    s.data.store(data, std::memory_order_relaxed);
+    s.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TransTable::addSample(std::uint64_t key, double value) {
+    Entry e;
+    if (!probe(key, e)) e = Entry{};          // miss or collision: replace
+    if (e.count == UINT32_MAX) return;
+    ++e.count;
+    e.mean += static_cast<float>((value - e.mean) / e.count);
+    store(key, e);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// ------------------------------------------------------------
+// TransTable — shared, lock-free transposition table
+//  • Direct-mapped on the low bits of a 64-bit position key
+//  • Each slot holds (key ^ data, data); a reader accepts the
+//    slot only if the two words still XOR to its key, so a torn
+//    write from a racing thread reads as a miss, never as a
+//    wrong entry (no locks, no CAS)
+//  • Payload is a running mean: sample count + mean value
+//  • Updates from racing threads may be lost; that only costs
+//    samples, never correctness
+// ------------------------------------------------------------
+class TransTable {
+public:
+    struct Entry {
+        std::uint32_t count{0};
+        float mean{0.0f};
+    };
+
+    explicit TransTable(int log2Slots = 16);
+
+    TransTable(const TransTable&) = delete;
+    TransTable& operator=(const TransTable&) = delete;
+
+    bool probe(std::uint64_t key, Entry& out) const;
+    void store(std::uint64_t key, const Entry& e);
+    void addSample(std::uint64_t key, double value);   // probe + fold in + store
+    void clear();
+
+    std::size_t slots() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};   // key ^ data
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    static std::uint64_t pack(const Entry& e);
+    static Entry unpack(std::uint64_t d);
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_;
+};
@@ -12,6 +12,9 @@ enum class PlayerId : int {
     P2 = 1
 };
 
+// The opponent of P1 or P2.
+inline PlayerId other(PlayerId p) { return p == PlayerId::P1 ? PlayerId::P2 : PlayerId::P1; }
+
 enum class GameState : int {
     Ongoing,
     Player1Wins,
@@ -35,11 +38,10 @@ using TerrId = int;
 // Territory Definition
 // --------------------------------------
 
+// Static map data; owners and armies live in Board.
 struct Territory {
     char code{'?'};                  // Letter code (A, B, C, …)
     std::string name;                // Optional display name
-    PlayerId owner{PlayerId::None};  // Who controls the territory
-    int armies{0};                   // Number of armies stationed
     std::vector<TerrId> adj;         // Adjacency list (neighboring territory IDs)
     int r{0};                        // Row on grid
     int c{0};                        // Column on grid
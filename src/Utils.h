@@ -1,7 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <random>
 #include <string>
 #include <cctype>
+#include "Rng.h"
 
 // ------------------------------------------------------------
 // RNG — reusable random number generator wrapper
@@ -22,6 +24,21 @@ struct RNG {
     }
 };
 
+// ------------------------------------------------------------
+// Seed derivation — independent 32-bit seeds from one master seed
+// ------------------------------------------------------------
+// One SplitMix64 step: the golden-ratio increment, then Rng::mix64.
+inline std::uint64_t splitmix64(std::uint64_t x) {
+    return Rng::mix64(x + 0x9E3779B97F4A7C15ull);
+}
+
+// Seed for (index, stream) under `master`; never 0 (0 means "default" to Game).
+inline std::uint32_t deriveSeed(std::uint64_t master, std::uint64_t index, std::uint64_t stream) {
+    std::uint64_t h = splitmix64(splitmix64(master ^ splitmix64(index)) + stream);
+    std::uint32_t s = static_cast<std::uint32_t>(h ^ (h >> 32));
+    return s ? s : 1u;
+}
+
 // ------------------------------------------------------------
 // String helpers
 // ------------------------------------------------------------
@@ -0,0 +1,34 @@
+#include "View.h"
+#include "IO.h"
+#include <iostream>
+
+// ---------- ConsoleView ----------
+void ConsoleView::message(const std::string& s) {
+    IO::println(s);
+}
+
+ConsoleView::~ConsoleView() {
+    if (pinnedRows_ == 0) return;
+    std::cout.flush();
+    BoardRenderer::present("\x1b[r");                        // release the scroll region
+}
+
+void ConsoleView::showBoard(const Board& b) {
+    if (!renderer_.changed(b)) return;
+    std::cout.flush();                  // keep ordering with earlier messages
+    if (!live_) {
+        BoardRenderer::present(renderer_.frame(b));
+        return;
+    }
+
+    const std::string& bytes = renderer_.update(b, 1);
+    if (renderer_.height() != pinnedRows_) {
+        // First frame (or a new map): clear, reserve the top rows for
+        // the board and let messages scroll in the region below it.
+        // A changed layout always comes with a full redraw in `bytes`.
+        pinnedRows_ = renderer_.height();
+        const std::string top = std::to_string(pinnedRows_ + 2);
+        BoardRenderer::present("\x1b[2J\x1b[" + top + "r\x1b[" + top + ";1H");
+    }
+    BoardRenderer::present(bytes);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include "Board.h"
+#include "Renderer.h"
+
+// ------------------------------------------------------------
+// View — where a match reports what happened
+//  • ConsoleView prints messages and the colour board; frames
+//    identical to the last one are skipped. In live mode the
+//    board is pinned to the top of the screen and redrawn in
+//    place (changed cells only), messages scroll beneath it
+//  • NullView discards everything (headless / batch play)
+// ------------------------------------------------------------
+class View {
+public:
+    virtual ~View() = default;
+
+    // False when output is discarded, so callers can skip formatting.
+    virtual bool enabled() const = 0;
+
+    virtual void message(const std::string& s) = 0;
+    virtual void showBoard(const Board& b) = 0;
+};
+
+class ConsoleView : public View {
+public:
+    explicit ConsoleView(int cellWidth = 3, bool live = false)
+        : renderer_(cellWidth), live_(live) {}
+    ~ConsoleView() override;
+
+    bool enabled() const override { return true; }
+    void message(const std::string& s) override;
+    void showBoard(const Board& b) override;
+
+private:
+    BoardRenderer renderer_;
+    bool live_;
+    int pinnedRows_{0};                 // live: lines reserved for the board
+};
+
+class NullView : public View {
+public:
+    bool enabled() const override { return false; }
+    void message(const std::string&) override {}
+    void showBoard(const Board&) override {}
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include "Rng.h"
+#include "Types.h"
+
+// ------------------------------------------------------------
+// Zobrist — position keys
+// ------------------------------------------------------------
+// A position's key is the XOR of one term per (territory, owner)
+// and one per (territory, armies), plus a side-to-move term, so a
+// mutation updates it by XORing the old term out and the new one
+// in. Army counts are unbounded, so terms are hashed on demand
+// instead of being read from a random table.
+//
+namespace Zobrist {
+
+    constexpr std::uint64_t kOwnerKey = 0x6A09E667F3BCC908ull;
+    constexpr std::uint64_t kArmyKey  = 0xBB67AE8584CAA73Bull;
+    constexpr std::uint64_t kSideKey  = 0x3C6EF372FE94F82Bull;
+
+    constexpr std::uint64_t owner(TerrId id, PlayerId p) {
+        return p == PlayerId::None
+            ? 0
+            : Rng::hash(kOwnerKey, static_cast<std::uint64_t>(id) * 2 + static_cast<int>(p));
+    }
+
+    constexpr std::uint64_t armies(TerrId id, int n) {
+        return Rng::hash(kArmyKey, (static_cast<std::uint64_t>(id) << 32) |
+                                   static_cast<std::uint32_t>(n));
+    }
+
+    constexpr std::uint64_t side(PlayerId toMove) {
+        return toMove == PlayerId::P2 ? kSideKey : 0;
+    }
+
+} // namespace Zobrist
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "src/Telemetry.h"
+
+// ------------------------------------------------------------
+// telemetry — summarize a telemetry file (see Telemetry.h)
+//  • telemetry <file>   results, then every column of both tables:
+//                       mean, min, max and streaming quantiles
+//  • One pass, chunk by chunk, in constant memory (P² quantiles),
+//    so files of tens of millions of games need no extra space
+// ------------------------------------------------------------
+namespace {
+
+constexpr double kQuantiles[] = {0.5, 0.9, 0.99};
+constexpr int kQuantileCount = sizeof(kQuantiles) / sizeof(kQuantiles[0]);
+
+struct ColumnStats {
+    std::uint64_t n{0};
+    double sum{0.0};
+    std::int64_t min{std::numeric_limits<std::int64_t>::max()};
+    std::int64_t max{std::numeric_limits<std::int64_t>::min()};
+    std::vector<Telemetry::Quantile> q;
+
+    ColumnStats() {
+        for (double p : kQuantiles) q.emplace_back(p);
+    }
+
+    void add(const std::vector<std::int64_t>& values) {
+        for (std::int64_t v : values) {
+            sum += static_cast<double>(v);
+            min = std::min(min, v);
+            max = std::max(max, v);
+            for (auto& e : q) e.add(static_cast<double>(v));
+        }
+        n += values.size();
+    }
+};
+
+struct TableStats {
+    Telemetry::Table table;
+    std::uint64_t rows{0};
+    std::vector<ColumnStats> columns;
+
+    explicit TableStats(Telemetry::Table t) : table(t), columns(Telemetry::columnCount(t)) {}
+};
+
+// Keys, and columns summarized elsewhere.
+bool skipped(Telemetry::Table t, int c) {
+    using namespace Telemetry;
+    return t == Table::Games ? (c == kGameId || c == kResult)
+                             : (c == kTurnGame || c == kPlayer);
+}
+
+void printTable(const TableStats& s, const char* title) {
+    std::cout << "\n" << std::left << std::setw(18) << title << std::right;
+    for (const char* h : {"mean", "min"}) std::cout << std::setw(10) << h;
+    for (double p : kQuantiles) std::cout << std::setw(10) << ("p" + std::to_string(static_cast<int>(p * 100)));
+    std::cout << std::setw(10) << "max" << "\n";
+    if (!s.rows) return;
+    for (int c = 0; c < static_cast<int>(s.columns.size()); ++c) {
+        if (skipped(s.table, c)) continue;
+        const ColumnStats& k = s.columns[c];
+        std::cout << std::left << std::setw(18) << Telemetry::columnName(s.table, c) << std::right
+                  << std::setprecision(2) << std::setw(10) << k.sum / static_cast<double>(k.n)
+                  << std::setw(10) << k.min;
+        for (const auto& e : k.q) std::cout << std::setprecision(1) << std::setw(10) << e.value();
+        std::cout << std::setw(10) << k.max << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: telemetry <file>\n";
+        return 1;
+    }
+    Telemetry::Reader r;
+    if (!r.open(argv[1])) {
+        std::cerr << "Not a telemetry file: " << argv[1] << "\n";
+        return 1;
+    }
+
+    TableStats games(Telemetry::Table::Games), turns(Telemetry::Table::Turns);
+    std::uint64_t chunks = 0, results[4] = {0, 0, 0, 0};
+    const bool whole = r.forEach([&](const Telemetry::Chunk& ch) {
+        TableStats& s = ch.table == Telemetry::Table::Games ? games : turns;
+        ++chunks;
+        s.rows += ch.rows;
+        for (int c = 0; c < static_cast<int>(s.columns.size()); ++c)
+            if (!skipped(s.table, c)) s.columns[c].add(ch.column(c));
+        if (ch.table == Telemetry::Table::Games)
+            for (std::int64_t v : ch.column(Telemetry::kResult))
+                if (v >= 0 && v < 4) ++results[v];
+    });
+
+    auto pct = [&](std::uint64_t k) { return games.rows ? 100.0 * k / games.rows : 0.0; };
+    std::cout << std::fixed << std::setprecision(1)
+              << "File:      " << argv[1] << ", " << r.size() / 1048576.0 << " MiB, "
+              << chunks << " chunks\n";
+    if (!whole)
+        std::cout << "Damaged:   after byte " << r.goodBytes() << "; the rest is ignored\n";
+    std::cout << "Games:     " << games.rows << " (P1 wins " << pct(results[1])
+              << "%, P2 wins " << pct(results[2]) << "%, draws " << pct(results[3]) << "%"
+              << (results[0] ? ", unfinished " + std::to_string(results[0]) : std::string()) << ")\n"
+              << "Turns:     " << turns.rows << "\n";
+    printTable(games, "per game");
+    printTable(turns, "per turn");
+    return 0;
+}
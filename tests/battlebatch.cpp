@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BattleBatch.h"
+#include "Rules.h"
+
+// ------------------------------------------------------------
+// battlebatch test — every kernel against the scalar one
+//  • rounds(): losses and stream position, and the scalar kernel
+//    against Rules::simulateBattleOnce
+//  • battles(): armies left and rounds fought
+//  • Sizes around the 8- and 16-lane widths, where the tail
+//    handling is
+// Exit status 1 on any mismatch.
+// ------------------------------------------------------------
+namespace {
+
+constexpr std::uint64_t kSeed = 20240601u;
+constexpr std::size_t kSizes[] = {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 1000};
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (ok) return;
+    ++failures;
+    std::cerr << "FAIL: " << what << "\n";
+}
+
+void checkRounds(BattleBatch::Isa isa, std::size_t n) {
+    std::vector<std::uint8_t> att(n), def(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        att[i] = static_cast<std::uint8_t>(1 + i % 3);
+        def[i] = static_cast<std::uint8_t>(1 + (i / 3) % 2);
+    }
+    std::vector<std::uint8_t> al0(n), dl0(n), al(n), dl(n);
+    Rng::Stream want(kSeed + n), got(kSeed + n);
+
+    BattleBatch::setIsa(BattleBatch::Isa::Scalar);
+    BattleBatch::rounds(att.data(), def.data(), al0.data(), dl0.data(), n, want);
+    BattleBatch::setIsa(isa);
+    BattleBatch::rounds(att.data(), def.data(), al.data(), dl.data(), n, got);
+
+    const std::string tag = std::string(BattleBatch::name(isa)) + " rounds n=" + std::to_string(n);
+    check(al == al0 && dl == dl0, tag + ": losses differ from scalar");
+    check(got.counter() == want.counter(), tag + ": stream position differs from scalar");
+
+    if (isa == BattleBatch::Isa::Scalar) {
+        Rng::Stream one(kSeed + n);
+        bool same = true;
+        for (std::size_t i = 0; i < n; ++i) {
+            const Rules::BattleLosses l = Rules::simulateBattleOnce(att[i], def[i], one);
+            same = same && l.attacker == al0[i] && l.defender == dl0[i];
+        }
+        check(same, tag + ": differs from Rules::simulateBattleOnce");
+    }
+}
+
+void checkBattles(BattleBatch::Isa isa, std::size_t n) {
+    std::vector<std::int32_t> a0(n), d0(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a0[i] = static_cast<std::int32_t>(2 + i % 23);
+        d0[i] = static_cast<std::int32_t>(1 + (i * 7) % 19);
+    }
+    std::vector<std::int32_t> a1 = a0, d1 = d0;
+    const Rng::Stream rng(kSeed ^ n);
+
+    BattleBatch::setIsa(BattleBatch::Isa::Scalar);
+    const std::uint64_t want = BattleBatch::battles(a0.data(), d0.data(), n, rng, 5);
+    BattleBatch::setIsa(isa);
+    const std::uint64_t got = BattleBatch::battles(a1.data(), d1.data(), n, rng, 5);
+
+    const std::string tag = std::string(BattleBatch::name(isa)) + " battles n=" + std::to_string(n);
+    check(a1 == a0 && d1 == d0, tag + ": armies left differ from scalar");
+    check(got == want, tag + ": rounds fought differ from scalar");
+}
+
+} // namespace
+
+int main() {
+    int kernels = 0;
+    for (BattleBatch::Isa isa : {BattleBatch::Isa::Scalar, BattleBatch::Isa::Avx2, BattleBatch::Isa::Avx512}) {
+        if (!BattleBatch::supported(isa)) {
+            std::cout << BattleBatch::name(isa) << ": not supported here, skipped\n";
+            continue;
+        }
+        ++kernels;
+        for (std::size_t n : kSizes) {
+            checkRounds(isa, n);
+            checkBattles(isa, n);
+        }
+    }
+    std::cout << "battlebatch: " << kernels << " kernels, "
+              << (failures ? std::to_string(failures) + " failures" : std::string("ok")) << "\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Board.h"
+#include "Telemetry.h"
+
+// ------------------------------------------------------------
+// telemetry test — Sink and Reader round trip
+//  • Every game and turn row written comes back, column for
+//    column, in game order (games added out of order included)
+//  • A second Sink on the same file appends, numbering its games
+//    on from the last id instead of reusing 0..n
+//  • A damaged tail is cut before the next append
+//  • A run killed before its first flush leaves turn rows with no
+//    game rows; the next run still numbers on past them
+// Exit status 1 on any mismatch.
+// ------------------------------------------------------------
+namespace {
+
+using namespace Telemetry;
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (ok) return;
+    ++failures;
+    std::cerr << "FAIL: " << what << "\n";
+}
+
+Board lineBoard() {
+    std::vector<Territory> ts(4);
+    for (TerrId t = 0; t < 4; ++t) {
+        ts[t].code = static_cast<char>('A' + t);
+        ts[t].c = t;
+        if (t > 0) ts[t].adj.push_back(t - 1);
+        if (t < 3) ts[t].adj.push_back(t + 1);
+    }
+    Board b(ts);
+    for (TerrId t = 0; t < 4; ++t) b.place(t, t < 2 ? PlayerId::P1 : PlayerId::P2, 3);
+    return b;
+}
+
+// Game k: 1 + k % 5 turns with made-up battles.
+GameLog makeLog(int k) {
+    GameLog log;
+    Board b = lineBoard();
+    log.begin();
+    const int turns = 1 + k % 5;
+    for (int t = 1; t <= turns; ++t) {
+        log.turn(t, t % 2 ? PlayerId::P1 : PlayerId::P2, b);
+        if (t % 3 == 0) log.bonus(5);
+        log.reinforce(3 + k);
+        log.battle(1, 2, t, 1, 2, (t + k) % 2 == 0);
+        b.addArmies(1, t);
+    }
+    log.finish(k % 2 ? GameState::Player1Wins : GameState::Draw, turns, b);
+    return log;
+}
+
+struct Rows {
+    std::vector<GameRow> games;
+    std::vector<TurnRow> turns;
+};
+
+// What the file should hold for games first..first+n-1 of makeLog.
+void expect(Rows& want, std::uint64_t first, int n) {
+    for (int k = 0; k < n; ++k) {
+        const GameLog log = makeLog(k);
+        GameRow g = log.game();
+        g[kGameId] = static_cast<std::int64_t>(first + k);
+        want.games.push_back(g);
+        for (TurnRow t : log.turns()) {
+            t[kTurnGame] = static_cast<std::int64_t>(first + k);
+            want.turns.push_back(t);
+        }
+    }
+}
+
+bool read(const std::string& path, Rows& got) {
+    Reader r;
+    if (!r.open(path)) return false;
+    return r.forEach([&](const Chunk& ch) {
+        for (std::size_t i = 0; i < ch.rows; ++i) {
+            if (ch.table == Table::Games) {
+                GameRow g{};
+                for (int c = 0; c < kGameColumns; ++c) g[c] = ch.column(c)[i];
+                got.games.push_back(g);
+            } else {
+                TurnRow t{};
+                for (int c = 0; c < kTurnColumns; ++c) t[c] = ch.column(c)[i];
+                got.turns.push_back(t);
+            }
+        }
+    });
+}
+
+void checkFile(const std::string& path, const Rows& want, const std::string& tag) {
+    Rows got;
+    check(read(path, got), tag + ": file not read whole");
+    check(got.games == want.games, tag + ": game rows differ");
+    check(got.turns == want.turns, tag + ": turn rows differ");
+}
+
+} // namespace
+
+int main() {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "minirisk-telemetry-test.mrtl").string();
+    std::remove(path.c_str());
+    Rows want;
+
+    // A new file; games 3 and 1 finish before 0 and wait for it.
+    {
+        Sink s(path);
+        check(s.ok(), "new file: not opened");
+        check(s.firstGame() == 0, "new file: first game not 0");
+        for (int k : {3, 1, 0, 2, 4, 5, 6}) s.add(static_cast<std::uint64_t>(k), makeLog(k));
+    }
+    expect(want, 0, 7);
+    checkFile(path, want, "new file");
+
+    // A second run appends games 7.. without reusing an id.
+    {
+        Sink s(path);
+        check(s.firstGame() == 7, "append: first game " + std::to_string(s.firstGame()) + ", not 7");
+        s.add(1, makeLog(1));
+        check(s.bufferedRows() == 1 + makeLog(1).turns().size(), "append: held game not buffered");
+        s.add(0, makeLog(0));
+        s.flush();
+        check(s.bufferedRows() == 0, "append: rows left after flush");
+        for (int k = 2; k < 5000; ++k) s.add(static_cast<std::uint64_t>(k), makeLog(k));
+    }
+    expect(want, 7, 5000);
+    checkFile(path, want, "append");
+
+    // Half a chunk from a crash is cut, and numbering still goes on.
+    if (std::FILE* f = std::fopen(path.c_str(), "ab")) {
+        std::fwrite("MRTC\x01", 1, 5, f);
+        std::fclose(f);
+    }
+    {
+        Sink s(path);
+        check(s.firstGame() == 5007, "damaged tail: first game " + std::to_string(s.firstGame()));
+        s.add(0, makeLog(0));
+    }
+    expect(want, 5007, 1);
+    checkFile(path, want, "damaged tail");
+
+    // A run killed before any flush: Turns chunks fill about three
+    // times sooner here, so one is on disk and no Games chunk is.
+    std::remove(path.c_str());
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        Sink s(path);
+        for (int k = 0; k < 2000; ++k) s.add(static_cast<std::uint64_t>(k), makeLog(k));
+        std::fflush(nullptr);                    // what was written reaches the file
+        ::_exit(0);                              // but the Sink never flushes
+    }
+    int status = 0;
+    check(pid > 0 && ::waitpid(pid, &status, 0) == pid, "crash: child did not run");
+    Rows crashed;
+    check(read(path, crashed), "crash: file not read whole");
+    check(crashed.games.empty() && crashed.turns.size() == kChunkRows,
+          "crash: expected one Turns chunk and no game rows");
+    if (!crashed.turns.empty()) {
+        const std::uint64_t last = static_cast<std::uint64_t>(crashed.turns.back()[kTurnGame]);
+        Sink s(path);
+        check(s.firstGame() == last + 1, "crash: first game " + std::to_string(s.firstGame()) +
+                                             ", not " + std::to_string(last + 1));
+    }
+
+    std::remove(path.c_str());
+    std::cout << "telemetry: " << want.games.size() << " games, " << want.turns.size() << " turns, "
+              << (failures ? std::to_string(failures) + " failures" : std::string("ok")) << "\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Game.h"
+#include "src/Controller.h"
+#include "src/Endgame.h"
+#include "src/GameRecord.h"
+#include "src/Instrument.h"
+#include "src/MCTS.h"
+#include "src/Telemetry.h"
+#include "src/ThreadPool.h"
+#include "src/Utils.h"
+#include "src/View.h"
+
+// ------------------------------------------------------------
+// tournament — headless self-play between two AI controllers
+//  • Games run on a work-stealing ThreadPool (one task per game)
+//  • Every seed derives from the master seed and the game index,
+//    so results are identical for any thread count
+//  • Seats alternate: AI "A" is Player 1 in even-numbered games
+//  • -e ends a game once the endgame solver finds it decided
+// ------------------------------------------------------------
+namespace {
+
+struct Options {
+    int games{1000};
+    unsigned threads{0};
+    std::uint64_t seed{1};
+    std::string aiA{"random"};
+    std::string aiB{"random"};
+    int repetition{Game::kRepetitionLimit};
+    bool watch{false};
+    int territories{MapSpec::kDefaultTerritories};
+    bool sharedMap{false};
+    std::string recordDir;        // empty = no game records
+    bool stats{false};
+    bool blitz{false};
+    unsigned decisionThreads{1};  // > 1 = intra-decision pool
+    ThreadPool* decisionPool{nullptr};
+    double adjudicate{0.0};       // > 0 = -e threshold
+    std::string tablePath;        // empty = no endgame table
+    const Endgame::Table* table{nullptr};
+    std::string telemetryPath;    // empty = no telemetry
+    Telemetry::Sink* telemetry{nullptr};
+};
+
+// Seed streams per game (see deriveSeed)
+enum Stream : std::uint64_t { kMap = 0, kDeal = 1, kBattle = 2, kSeatA = 3, kSeatB = 4 };
+
+struct GameResult {
+    int winner{-1};   // 0 = A, 1 = B, -1 = draw
+    int turns{0};
+    bool adjudicated{false};
+};
+
+void usage() {
+    std::cout
+        << "Usage: tournament [options]\n"
+        << "  -n <games>     number of games (default 1000)\n"
+        << "  -j <threads>   worker threads (default: all cores)\n"
+        << "  -d <threads>   threads per AI decision (default 1; MCTS grows one tree each,\n"
+        << "                 RandomAI choices are the same for any count)\n"
+        << "  -s <seed>      master seed (default 1)\n"
+        << "  -a <ai>        controller A: random | mcts | mcts:<iterations> | mcts:<level>\n"
+        << "                 (levels: easy, normal, hard, analysis); append +eg to play\n"
+        << "                 solvable endgames perfectly (e.g. random+eg)\n"
+        << "  -b <ai>        controller B (same choices)\n"
+        << "  -r <n>         draw when an ownership map recurs n times (default off)\n"
+        << "  -m <n>         territories per map (default "
+        << MapSpec::kDefaultTerritories << "; other sizes use MapSpec::build)\n"
+        << "  -z             blitz: every attack fights to the end in one step\n"
+        << "  -e <p>         adjudicate when the endgame solver gives one side a win\n"
+        << "                 with probability >= p within its horizon (0.5 < p <= 1, e.g. 0.99)\n"
+        << "  -T <file>      endgame table (built by endgame) for +eg and -e\n"
+        << "  -f             fixed map: all games share game 0's map (one MapTopology)\n"
+        << "  -o <dir>       write a binary record of game i to <dir>/game-<i>.mrr\n"
+        << "  -t <file>      append per-game and per-turn statistics to <file> (see telemetry)\n"
+        << "  -w             watch game 0 live in the terminal instead\n"
+        << "  -i             print instrumentation (phase times, decision latency, counters)\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "-h" || a == "--help") { usage(); return false; }
+        if (a == "-w") { o.watch = true; continue; }
+        if (a == "-f") { o.sharedMap = true; continue; }
+        if (a == "-i") { o.stats = true; continue; }
+        if (a == "-z") { o.blitz = true; continue; }
+        if (a != "-n" && a != "-j" && a != "-s" && a != "-a" && a != "-b" && a != "-r" &&
+            a != "-m" && a != "-o" && a != "-d" && a != "-T" && a != "-e" && a != "-t") {
+            std::cerr << "Unknown option: " << a << "\n";
+            usage();
+            return false;
+        }
+        if (!(v = next())) { std::cerr << "Missing value for " << a << "\n"; return false; }
+        if (a == "-n") o.games = std::atoi(v);
+        else if (a == "-j") o.threads = static_cast<unsigned>(std::atoi(v));
+        else if (a == "-s") o.seed = std::strtoull(v, nullptr, 10);
+        else if (a == "-a") o.aiA = v;
+        else if (a == "-b") o.aiB = v;
+        else if (a == "-r") o.repetition = std::atoi(v);
+        else if (a == "-m") o.territories = std::atoi(v);
+        else if (a == "-o") o.recordDir = v;
+        else if (a == "-d") o.decisionThreads = static_cast<unsigned>(std::max(1, std::atoi(v)));
+        else if (a == "-T") o.tablePath = v;
+        else if (a == "-e") o.adjudicate = std::atof(v);
+        else if (a == "-t") o.telemetryPath = v;
+    }
+    return o.games > 0 && o.territories > 1 &&
+           (o.adjudicate == 0.0 || (o.adjudicate > 0.5 && o.adjudicate <= 1.0));
+}
+
+// "random", "mcts", "mcts:<iterations>" or "mcts:<difficulty>", each
+// optionally with "+eg" (EndgameController around it)
+std::unique_ptr<Controller> makeController(const std::string& name, std::uint32_t seed,
+                                           ThreadPool* pool = nullptr, bool blitz = false,
+                                           const Endgame::Table* table = nullptr) {
+    const std::string eg = "+eg";
+    if (name.size() > eg.size() && name.compare(name.size() - eg.size(), eg.size(), eg) == 0) {
+        auto inner = makeController(name.substr(0, name.size() - eg.size()), seed, pool);
+        if (!inner) return nullptr;
+        Endgame::Config cfg;
+        cfg.blitz = blitz;
+        return std::make_unique<EndgameController>(std::move(inner), cfg, table);
+    }
+    if (name == "random") return std::make_unique<RandomAIController>(seed, pool);
+    if (name.rfind("mcts", 0) == 0) {
+        MCTS::Config cfg;
+        if (name.size() > 5 && name[4] == ':') {
+            const std::string arg = name.substr(5);
+            Difficulty level;
+            if (parseDifficulty(arg, level)) cfg = MCTS::Config::forLevel(level);
+            else if (arg.find_first_not_of("0123456789") != std::string::npos) return nullptr;
+            else cfg.budget = {std::max(1, std::atoi(arg.c_str())), 0.0};
+        } else if (name.size() != 4) {
+            return nullptr;
+        }
+        if (pool) {
+            cfg.pool = pool;
+            cfg.threads = pool->size();
+        }
+        return std::make_unique<MCTSController>(seed, cfg);
+    }
+    return nullptr;
+}
+
+GameResult playOne(const Options& o, const std::shared_ptr<const MapTopology>& map,
+                   int index, View& view) {
+    const std::uint64_t m = o.seed;
+    Game game = map ? Game(map, deriveSeed(m, 0, kMap))      // the seed `map` came from
+                    : Game(deriveSeed(m, index, kMap), o.territories);
+    game.setupStartingPositions(deriveSeed(m, index, kDeal));
+    game.setBattleSeed(deriveSeed(m, index, kBattle));
+    game.setRepetitionLimit(o.repetition);
+    game.setBlitz(o.blitz);
+
+    std::unique_ptr<GameRecorder> rec;
+    if (!o.recordDir.empty()) {
+        rec = std::make_unique<GameRecorder>(o.recordDir + "/game-" + std::to_string(index) + ".mrr");
+        if (rec->ok()) game.setRecorder(rec.get());
+        else std::cerr << "Cannot write record for game " << index << " in " << o.recordDir << "\n";
+    }
+
+    Telemetry::GameLog log;
+    if (o.telemetry) game.setTelemetry(&log);
+
+    auto a = makeController(o.aiA, deriveSeed(m, index, kSeatA), o.decisionPool, o.blitz, o.table);
+    auto b = makeController(o.aiB, deriveSeed(m, index, kSeatB), o.decisionPool, o.blitz, o.table);
+    bool aFirst = (index % 2 == 0);
+
+    GameResult r;
+    GameState s;
+    if (o.adjudicate <= 0.0) {
+        s = aFirst ? game.play(*a, *b, view) : game.play(*b, *a, view);
+    } else {
+        // play(), with a look at each turn's position before it is played.
+        Controller& p1 = aFirst ? *a : *b;
+        Controller& p2 = aFirst ? *b : *a;
+        Endgame::Config cfg;
+        cfg.blitz = o.blitz;
+        Endgame::Solver judge(cfg);
+        judge.setTable(o.table);
+        int wait = 0, backoff = 1;        // turns to skip after a solve over budget
+        game.start(view);
+        while (game.pendingDecision().kind != Game::DecisionKind::None) {
+            const Game::Decision d = game.pendingDecision();
+            Endgame::Value v;
+            bool solved = false;
+            if (d.kind == Game::DecisionKind::Reinforce && wait-- <= 0 && judge.inRange(game.board())) {
+                solved = judge.solve(game.board(), {Endgame::Stage::Reinforce, d.player, d.amount}, v);
+                wait = solved ? 0 : backoff;
+                backoff = solved ? 1 : std::min(2 * backoff, 32);
+            }
+            if (solved && std::max(v.win, v.loss) >= o.adjudicate) {
+                const bool p1Wins = (v.win >= o.adjudicate) == (d.player == PlayerId::P1);
+                game.adjudicate(p1Wins ? GameState::Player1Wins : GameState::Player2Wins, view);
+                r.adjudicated = true;
+                break;
+            }
+            game.answer(d.player == PlayerId::P1 ? p1 : p2, view);
+        }
+        s = game.finish(view);
+    }
+
+    if (o.telemetry) o.telemetry->add(static_cast<std::uint64_t>(index), log);
+    r.turns = game.turnsPlayed();
+    if (s == GameState::Player1Wins) r.winner = aFirst ? 0 : 1;
+    else if (s == GameState::Player2Wins) r.winner = aFirst ? 1 : 0;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 1;
+    for (const auto& name : {opt.aiA, opt.aiB})
+        if (!makeController(name, 1)) { std::cerr << "Unknown AI: " << name << "\n"; return 1; }
+
+    // Decisions fan out on their own pool so they never queue behind games.
+    std::unique_ptr<ThreadPool> decisionPool;
+    if (opt.decisionThreads > 1) {
+        decisionPool = std::make_unique<ThreadPool>(opt.decisionThreads);
+        opt.decisionPool = decisionPool.get();
+    }
+
+    Endgame::Table table;
+    if (!opt.tablePath.empty()) {
+        if (!table.open(opt.tablePath)) {
+            std::cerr << "Not an endgame table: " << opt.tablePath << "\n";
+            return 1;
+        }
+        opt.table = &table;
+    }
+
+    std::unique_ptr<Telemetry::Sink> sink;
+    if (!opt.telemetryPath.empty()) {
+        sink = std::make_unique<Telemetry::Sink>(opt.telemetryPath);
+        if (!sink->ok()) {
+            std::cerr << "Cannot append telemetry to " << opt.telemetryPath << "\n";
+            return 1;
+        }
+        opt.telemetry = sink.get();
+    }
+
+    std::shared_ptr<const MapTopology> map;
+    if (opt.sharedMap) {
+        const auto seed = static_cast<unsigned>(deriveSeed(opt.seed, 0, kMap));
+        map = MapTopology::make(opt.territories == MapSpec::kDefaultTerritories
+                                    ? MapSpec::build20(seed)
+                                    : MapSpec::build(opt.territories, seed));
+    }
+
+    if (opt.watch) {
+        Instrument::setDumpAtGameEnd(opt.stats);
+        GameResult r;
+        {
+            ConsoleView view(3, /*live=*/true);
+            r = playOne(opt, map, 0, view);
+        }
+        std::cout << (r.winner == 0 ? "A wins" : r.winner == 1 ? "B wins" : "Draw")
+                  << " after " << r.turns << " turns\n";
+        return 0;
+    }
+
+    std::vector<GameResult> results(opt.games);
+    auto t0 = std::chrono::steady_clock::now();
+    unsigned threads = 0;
+    {
+        ThreadPool pool(opt.threads);
+        threads = pool.size();
+        for (int i = 0; i < opt.games; ++i)
+            pool.submit([&opt, &map, &results, i]{
+                NullView view;
+                results[i] = playOne(opt, map, i, view);
+            });
+        pool.wait();
+    }
+    if (sink) sink->flush();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // ---------- Aggregate (in game order, so output is thread-count independent) ----------
+    int winsA = 0, winsB = 0, draws = 0, adjudicated = 0, minT = results[0].turns, maxT = 0;
+    long long totalT = 0;
+    std::uint64_t digest = 0;
+    for (int i = 0; i < opt.games; ++i) {
+        const auto& r = results[i];
+        if (r.winner == 0) ++winsA; else if (r.winner == 1) ++winsB; else ++draws;
+        adjudicated += r.adjudicated;
+        totalT += r.turns;
+        minT = std::min(minT, r.turns);
+        maxT = std::max(maxT, r.turns);
+        digest = splitmix64(digest ^ (static_cast<std::uint64_t>(r.turns) << 2) ^ (r.winner + 1));
+    }
+
+    auto pct = [&](int k) { return 100.0 * k / opt.games; };
+    std::cout << std::fixed << std::setprecision(1)
+              << "Games:   " << opt.games << " (" << opt.aiA << " vs " << opt.aiB
+              << ", seed " << opt.seed << ", " << threads << " threads)\n"
+              << "A wins:  " << winsA << " (" << pct(winsA) << "%)\n"
+              << "B wins:  " << winsB << " (" << pct(winsB) << "%)\n"
+              << "Draws:   " << draws << " (" << pct(draws) << "%)\n"
+              << (opt.adjudicate > 0.0
+                      ? "Decided: " + std::to_string(adjudicated) + " by the endgame solver\n"
+                      : std::string())
+              << "Turns:   mean " << static_cast<double>(totalT) / opt.games
+              << ", min " << minT << ", max " << maxT << "\n"
+              << "Speed:   " << opt.games / secs << " games/sec (" << secs << " s)\n"
+              << "Digest:  " << std::hex << digest << std::dec << "\n";
+    if (opt.stats) Instrument::dump(std::cout);
+    return 0;
+}